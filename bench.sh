@@ -0,0 +1,55 @@
+#!/bin/sh
+# bench.sh - headless scaling benchmark for ornament.
+# Generates synthetic configs (mixed shapes/colours/anchors spread over 1..4 virtual screens),
+# runs each for a fixed number of frames with a fixed --seed, and collects the --stats-json
+# output into one JSON array.
+#
+# usage: ./bench.sh [path/to/ornament]
+# env:   BENCH_SHAPES  shape counts      (default "10 100 1000 10000 100000")
+#        BENCH_SCREENS screen counts     (default "1 2 3 4")
+#        BENCH_FRAMES  frames per config (default 30)
+#        BENCH_SIZE    offscreen WxH     (default 1280x720)
+#        BENCH_OUT     result file       (default bench.json)
+#        BENCH_LAYOUT  packed|stacked    (default stacked: same placement as earlier runs, so
+#                      dense configs keep their off-screen stacks instead of filling the screen)
+set -e
+
+BIN=${1:-./ornament}
+SHAPES=${BENCH_SHAPES:-"10 100 1000 10000 100000"}
+SCREENS=${BENCH_SCREENS:-"1 2 3 4"}
+FRAMES=${BENCH_FRAMES:-30}
+SIZE=${BENCH_SIZE:-1280x720}
+OUT=${BENCH_OUT:-bench.json}
+LAYOUT=${BENCH_LAYOUT:-stacked}
+
+[ -x "$BIN" ] || { echo "bench: $BIN not found (build with ./compile.sh first)" >&2; exit 1; }
+TMP=$(mktemp -d "${TMPDIR:-/tmp}/ornament-bench.XXXXXX")
+trap 'rm -rf "$TMP"' EXIT
+
+# gen_config <shapes> <screens> <file>: deterministic round-robin over every ShapeKind, colour and anchor
+gen_config() {
+    awk -v n="$1" -v s="$2" 'BEGIN {
+        split("CUBE SPHERE PYRAMID TORUS OCTAHEDRON", sh, " ");
+        split("GREEN YELLOW RED BLUE CYAN PINK ORANGE PURPLE RANDOM", co, " ");
+        split("TOP-LEFT TOP-CENTER TOP-RIGHT CENTER-LEFT CENTER CENTER-RIGHT BOTTOM-LEFT BOTTOM-CENTER BOTTOM-RIGHT", po, " ");
+        printf("# synthetic bench config: %d shapes over %d screens\n", n, s);
+        for (i = 0; i < n; i++)
+            printf("%s=[%s, %s, %d]\n", sh[i % 5 + 1], co[i % 9 + 1], po[int(i / 5) % 9 + 1], i % s);
+    }' > "$3"
+}
+
+first=1
+printf '[\n' > "$OUT"
+for n in $SHAPES; do
+    for s in $SCREENS; do
+        cfg="$TMP/bench_${n}_${s}.ini"; res="$TMP/bench_${n}_${s}.json"
+        gen_config "$n" "$s" "$cfg"
+        echo "bench: $n shapes x $s screens, $FRAMES frames" >&2
+        "$BIN" --headless --seed 1 --headless-size "$SIZE" --frames "$FRAMES" --layout "$LAYOUT" --config "$cfg" --stats-json "$res" >/dev/null
+        [ $first -eq 1 ] || printf ',\n' >> "$OUT"
+        first=0
+        tr -d '\n' < "$res" >> "$OUT"
+    done
+done
+printf '\n]\n' >> "$OUT"
+echo "bench: results in $OUT" >&2
@@ -1 +1,31 @@
-gcc -std=c11 ornament.c -o ornament.exe -lglfw3 -lopengl32 -lgdi32 -lm
+#!/bin/sh
+# usage: ./compile.sh [bench|microbench]
+#   (no target)  build ornament (sphere/torus meshes baked at build time by gen_meshes.c)
+#   bench        build ornament, then run the headless scaling benchmark (bench.sh)
+#   microbench   build and run the math/colour kernel microbenchmarks (microbench.c)
+set -e
+cd "$(dirname "$0")"
+
+# build <source> <output name without extension> [extra compiler flags...]
+build() {
+    src=$1; out=$2; shift 2
+    case "$(uname -s)" in
+        MINGW*|MSYS*|CYGWIN*) gcc -std=c11 -O2 "$@" "$src" -o "$out.exe" -lglfw3 -lopengl32 -lgdi32 -lm ;;
+        Darwin)               cc -std=c11 -O2 -pthread "$@" "$src" -lglfw -framework OpenGL -framework Cocoa -framework IOKit -framework CoreVideo -o "$out" ;;
+        *)                    cc -std=c11 -O2 -pthread "$@" "$src" -lglfw -lGL -ldl -lm -lrt -o "$out" ;; # -lrt: shm_open on glibc < 2.34
+    esac
+}
+
+# generate ornament_meshes.h, then build with the baked tables
+build_ornament() {
+    build gen_meshes.c gen_meshes
+    ./gen_meshes ornament_meshes.h
+    build ornament.c ornament -DORNAMENT_BAKED_MESHES
+}
+
+case "$1" in
+    "") build_ornament ;;
+    bench) build_ornament && ./bench.sh ./ornament ;;
+    microbench) build microbench.c microbench && ./microbench ;;
+    *) echo "unknown target: $1" >&2; exit 1 ;;
+esac
@@ -0,0 +1,40 @@
+// gen_meshes.c - build-time generator for ornament's baked sphere/torus tables.
+// Runs the same make_sphere/make_torus code at every level of SPHERE_LOD/TORUS_LOD and
+// writes the results as static const tables, which ornament.c includes when built with
+// -DORNAMENT_BAKED_MESHES.
+//
+// Build: cc -std=c11 -O2 gen_meshes.c -lglfw -lGL -ldl -lm -o gen_meshes   (./compile.sh does this)
+// Usage: gen_meshes <out.h>
+
+#define ORNAMENT_NO_MAIN
+#undef ORNAMENT_BAKED_MESHES
+#include "ornament.c"
+
+static void emit(FILE* f, const char* name, int lod, WireGeom g){
+    fprintf(f, "static const vec3 %s_%d_V[%d] = {\n", name, lod, g.vcount);
+    for(int i=0;i<g.vcount;i++) fprintf(f, "    {%.9g,%.9g,%.9g},\n", g.verts[i].x, g.verts[i].y, g.verts[i].z);
+    fprintf(f, "};\nstatic const unsigned %s_%d_E[%d] = {", name, lod, g.lcount*2);
+    for(int i=0;i<g.lcount*2;i++) fprintf(f, "%s%u,", i%16? "" : "\n    ", g.lines[i]);
+    fprintf(f, "\n};\n");
+}
+
+int main(int argc, char** argv){
+    if(argc!=2){ fprintf(stderr,"usage: %s <out.h>\n", argv[0]); return 1; }
+    FILE* f=fopen(argv[1],"wb"); if(!f){ fprintf(stderr,"cannot write %s\n", argv[1]); return 1; }
+    Arena ar={0};
+    WireGeom sphere[MESH_LODS], torus[MESH_LODS];
+    fprintf(f, "// ornament_meshes.h - generated by gen_meshes.c at build time; do not edit.\n\n");
+    for(int l=0;l<MESH_LODS;l++){
+        sphere[l]=make_sphere(&ar, SPHERE_LOD[l][0], SPHERE_LOD[l][1]); emit(f, "BAKED_SPHERE", l, sphere[l]);
+        torus[l]=make_torus(&ar, TORUS_LOD[l][0], TORUS_LOD[l][1], TORUS_R, TORUS_r); emit(f, "BAKED_TORUS", l, torus[l]);
+    }
+    const char* names[2]={ "BAKED_SPHERE", "BAKED_TORUS" }; WireGeom* sets[2]={ sphere, torus };
+    for(int k=0;k<2;k++){
+        fprintf(f, "\nstatic const WireGeom %s[MESH_LODS] = {\n", names[k]);
+        for(int l=0;l<MESH_LODS;l++) fprintf(f, "    { %s_%d_V, %s_%d_E, %d, %d },\n", names[k], l, names[k], l, sets[k][l].vcount, sets[k][l].lcount);
+        fprintf(f, "};\n");
+    }
+    arena_free(&ar);
+    if(fclose(f)!=0){ fprintf(stderr,"write failed: %s\n", argv[1]); return 1; }
+    return 0;
+}
@@ -0,0 +1,328 @@
+// microbench.c - ns/op microbenchmarks for ornament's per-shape CPU kernels
+// (sincos, acos, q_slerp, q_mul, q_from_euler, m4_mul, m4_from_quat, m4_trs, instances, hsv2rgb,
+// update_shape).
+//
+// Each kernel runs over a batch of randomised inputs: warmup, then R timed repetitions,
+// reported as mean ns/op with a 95% confidence interval. A kernel may carry an alternative
+// implementation (vectorised/approximate); it is timed the same way and its outputs are
+// compared against the reference to report the maximum absolute error.
+//
+// --accuracy sweeps fast_sincosf/fast_acosf against libm over their whole documented domain
+// (not just the batch) and fails if an error bound stated in ornament.c is exceeded. It also
+// runs both animation models for the same seed and checks that they agree on spin and colour.
+//
+// Build: cc -std=c11 -O2 microbench.c -lglfw -lGL -ldl -lm -o microbench   (or ./compile.sh microbench)
+// Usage: microbench [--reps R] [--batch N] [--filter substring] [--accuracy]
+
+#define ORNAMENT_NO_MAIN
+#include "ornament.c"
+
+// --------------------------- Clock ---------------------------
+static uint64_t now_ns(void){
+#ifdef _WIN32
+    static LARGE_INTEGER freq; LARGE_INTEGER c; if(!freq.QuadPart) QueryPerformanceFrequency(&freq); QueryPerformanceCounter(&c);
+    return (uint64_t)(c.QuadPart/freq.QuadPart)*1000000000u + (uint64_t)(c.QuadPart%freq.QuadPart)*1000000000u/(uint64_t)freq.QuadPart;
+#else
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts); return (uint64_t)ts.tv_sec*1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// --------------------------- Scalar references ---------------------------
+// Scalar slerp; vq_slerp in ornament.c must stay equivalent to it.
+static quat q_slerp(quat a, quat b, float t){
+    a=q_norm(a); b=q_norm(b);
+    float dot=a.x*b.x + a.y*b.y + a.z*b.z + a.w*b.w;
+    if(dot<0){ b.x=-b.x; b.y=-b.y; b.z=-b.z; b.w=-b.w; dot=-dot; }
+    if(dot>0.9995f){ // lerp
+        quat r={ a.x + t*(b.x-a.x), a.y + t*(b.y-a.y), a.z + t*(b.z-a.z), a.w + t*(b.w-a.w)}; return q_norm(r);
+    }
+    // sin(th)=sqrt((1-dot)(1+dot)), sin((1-t)th)=sin(th)cos(t*th)-dot*sin(t*th): one sincos
+    float th = trig_acos(dot), st, ct; trig_sincos(t*th, &st, &ct);
+    float s2 = st/sqrtf((1-dot)*(1+dot));
+    float s1 = ct - dot*s2;
+    quat r={ a.x*s1 + b.x*s2, a.y*s1 + b.y*s2, a.z*s1 + b.z*s2, a.w*s1 + b.w*s2 };
+    return r;
+}
+
+// Generic matrix building blocks that m4_trs replaces in ornament.c.
+static mat4 m4_mul(mat4 a, mat4 b){ mat4 r; for(int i=0;i<4;i++) for(int j=0;j<4;j++){ r.m[i*4+j]=0; for(int k=0;k<4;k++) r.m[i*4+j]+=a.m[i*4+k]*b.m[k*4+j]; } return r; }
+static mat4 m4_translate(vec3 t){ mat4 m=m4_ident(); m.m[12]=t.x; m.m[13]=t.y; m.m[14]=t.z; return m; }
+static mat4 m4_from_quat(quat q){ q=q_norm(q); float x=q.x,y=q.y,z=q.z,w=q.w; mat4 m=m4_ident();
+    m.m[0]=1-2*y*y-2*z*z; m.m[1]=2*x*y+2*w*z;   m.m[2]=2*x*z-2*w*y;
+    m.m[4]=2*x*y-2*w*z;   m.m[5]=1-2*x*x-2*z*z; m.m[6]=2*y*z+2*w*x;
+    m.m[8]=2*x*z+2*w*y;   m.m[9]=2*y*z-2*w*x;   m.m[10]=1-2*x*x-2*y*y; return m; }
+
+// Same-capacity copy (the stream layout depends only on cap).
+static void anim_copy(ShapeAnim* dst, const ShapeAnim* src){
+    size_t bytes = sizeof(float)*(size_t)src->cap*ANIM_FLOAT_STREAMS + (sizeof(Rng)+sizeof(KeySeg)+sizeof(uint32_t))*(size_t)src->cap;
+    memcpy(dst->hue, src->hue, bytes); dst->count=src->count; dst->seed=src->seed;
+}
+
+static quat anim_orient(const ShapeAnim* a, int i){ quat q={ a->ox[i], a->oy[i], a->oz[i], a->ow[i] }; return q; }
+static quat anim_prev_orient(const ShapeAnim* a, int i){ quat q={ a->px[i], a->py[i], a->pz[i], a->pw[i] }; return q; }
+// Orientation between the last two sim steps; alpha in [0,1] is the accumulator remainder.
+static quat anim_orient_lerp(const ShapeAnim* a, int i, float alpha){ return q_slerp(anim_prev_orient(a,i), anim_orient(a,i), alpha); }
+static quat anim_target(const ShapeAnim* a, int i){ quat q={ a->tx[i], a->ty[i], a->tz[i], a->tw[i] }; return q; }
+// Scalar reference for one shape; ornament's update_shapes must stay equivalent to it.
+static void update_shape(ShapeAnim* a, int i, float dt){
+    // reorientation timing
+    a->timer[i] -= dt;
+    float spinScale=1.0f;
+    quat orient=anim_orient(a,i);
+    if(a->timer[i] <= 0.0f || a->t[i]>0.0f){
+        if(a->t[i]==0.0f) anim_new_target(a, i); // start new
+        a->t[i] += dt / a->dur[i];
+        if(a->t[i] >= 1.0f){ orient = anim_target(a,i); a->t[i]=0.0f; a->timer[i] = rng_range(&a->rng[i],4,8); }
+        else { orient = q_slerp(orient, anim_target(a,i), a->t[i]); spinScale=0.5f; }
+    }
+    // continuous spin
+    float dYaw = a->spinY[i] * spinScale * dt * (float)M_PI/180.0f;
+    float dPitch = a->spinX[i] * spinScale * dt * (float)M_PI/180.0f;
+    quat dq = q_mul(q_from_axis_angle(v3(0,1,0), dYaw), q_from_axis_angle(v3(1,0,0), dPitch));
+    anim_set_orient(a, i, q_mul(dq, orient));
+}
+
+// --------------------------- Inputs ---------------------------
+// Fixed-seed splitmix64 so every run (and every build being compared) sees the same inputs.
+static uint64_t g_rng = 0x9E3779B97F4A7C15ull;
+static float urand(float a, float b){
+    uint64_t z = (g_rng += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z>>30)) * 0xBF58476D1CE4E5B9ull; z = (z ^ (z>>27)) * 0x94D049BB133111EBull; z ^= z>>31;
+    return a + (b-a)*(float)((z>>40)*(1.0/16777216.0));
+}
+static quat urand_quat(void){ return q_norm((quat){ urand(-1,1), urand(-1,1), urand(-1,1), urand(-1,1) }); }
+
+#define MAX_BATCH 65536
+static int g_batch = 4096;
+static struct {
+    quat qa[MAX_BATCH], qb[MAX_BATCH]; float t[MAX_BATCH];
+    vec3 euler[MAX_BATCH];
+    mat4 ma[MAX_BATCH], mb[MAX_BATCH];
+    float h[MAX_BATCH];
+    float ang[MAX_BATCH], cosv[MAX_BATCH];
+} g_in;
+static ShapeAnim g_anim, g_animInit;
+static ShapeRuntime g_rt[MAX_BATCH];
+static float g_out[MAX_BATCH*16];
+
+static void init_inputs(void){
+    for(int i=0;i<MAX_BATCH;i++){
+        g_in.qa[i]=urand_quat(); g_in.qb[i]=urand_quat(); g_in.t[i]=urand(0,1);
+        g_in.euler[i]=v3(urand(-1.5f,1.5f), urand(-1.5f,1.5f), urand(-1.5f,1.5f));
+        for(int k=0;k<16;k++){ g_in.ma[i].m[k]=urand(-1,1); g_in.mb[i].m[k]=urand(-1,1); }
+        g_in.h[i]=urand(0,0.999f);
+        g_in.ang[i]=urand(-2*(float)M_PI, 2*(float)M_PI); g_in.cosv[i]=urand(-1,1);
+    }
+    anim_init(&g_animInit, MAX_BATCH, NULL); anim_init(&g_anim, MAX_BATCH, NULL);
+    ShapeAnim* a=&g_animInit;
+    for(int i=0;i<MAX_BATCH;i++){
+        a->rng[i]=rng_seed(12345, (uint64_t)i);
+        a->hue[i]=urand(0,1); a->hueSpeed[i]=urand(0.25f,0.5f);
+        anim_set_orient(a, i, urand_quat()); anim_set_target(a, i, urand_quat());
+        a->spinY[i]=urand(180,360); a->spinX[i]=urand(15,45);
+        // a spread of timers so a realistic fraction of shapes is mid-reorientation
+        a->timer[i]=urand(-2,8); a->dur[i]=urand(1.5f,2.5f); a->t[i]= a->timer[i]<0? urand(0,0.9f) : 0.0f;
+        // previous sim step: a small rotation away from the current orientation
+        quat p=q_mul(q_from_axis_angle(v3(0,1,0), urand(0.01f,0.1f)), anim_orient(a,i));
+        a->px[i]=p.x; a->py[i]=p.y; a->pz[i]=p.z; a->pw[i]=p.w;
+        g_rt[i].worldPos=v3(urand(-1,1), urand(-1,1), 0); g_rt[i].scale=1.0f;
+    }
+    anim_copy(&g_anim, &g_animInit);
+}
+
+// --------------------------- Kernels (reference = current scalar code) ---------------------------
+// Trig-dependent kernels run their reference with libm and their alternative with the
+// polynomials, regardless of the --trig default.
+static void k_sincos_libm(int n, float* out){ for(int i=0;i<n;i++){ out[i*2]=sinf(g_in.ang[i]); out[i*2+1]=cosf(g_in.ang[i]); } }
+static void k_sincos_fast(int n, float* out){ for(int i=0;i<n;i++) fast_sincosf(g_in.ang[i], out+i*2, out+i*2+1); }
+static void k_acos_libm(int n, float* out){ for(int i=0;i<n;i++) out[i]=acosf(g_in.cosv[i]); }
+static void k_acos_fast(int n, float* out){ for(int i=0;i<n;i++) out[i]=fast_acosf(g_in.cosv[i]); }
+static void k_q_slerp(int n, float* out){ for(int i=0;i<n;i++){ quat r=q_slerp(g_in.qa[i], g_in.qb[i], g_in.t[i]); memcpy(out+i*4,&r,sizeof(r)); } }
+static void k_q_slerp_libm(int n, float* out){ g_trigLibm=1; k_q_slerp(n, out); g_trigLibm=0; }
+static void k_q_slerp_fast(int n, float* out){ g_trigLibm=0; k_q_slerp(n, out); }
+static void k_q_mul(int n, float* out){ for(int i=0;i<n;i++){ quat r=q_mul(g_in.qa[i], g_in.qb[i]); memcpy(out+i*4,&r,sizeof(r)); } }
+static void k_q_from_euler(int n, float* out){ for(int i=0;i<n;i++){ vec3 e=g_in.euler[i]; quat r=q_from_euler(e.x,e.y,e.z); memcpy(out+i*4,&r,sizeof(r)); } }
+static void k_m4_mul(int n, float* out){ for(int i=0;i<n;i++){ mat4 r=m4_mul(g_in.ma[i], g_in.mb[i]); memcpy(out+i*16,&r,sizeof(r)); } }
+static void k_m4_from_quat(int n, float* out){ for(int i=0;i<n;i++){ mat4 r=m4_from_quat(g_in.qa[i]); memcpy(out+i*16,&r,sizeof(r)); } }
+// generic T*R*S; m4_mul(a,b) is b*a in column-major terms, hence the operand order
+static mat4 compose_trs(vec3 t, quat q, float s){ return m4_mul(m4_mul(m4_scale(s), m4_from_quat(q)), m4_translate(t)); }
+static void k_m4_compose(int n, float* out){ for(int i=0;i<n;i++){ mat4 r=compose_trs(g_rt[i].worldPos, g_in.qa[i], SHAPE_SCALE); memcpy(out+i*16,&r,sizeof(r)); } }
+static void k_m4_trs(int n, float* out){ for(int i=0;i<n;i++){ mat4 r=m4_trs(g_rt[i].worldPos, g_in.qa[i], SHAPE_SCALE); memcpy(out+i*16,&r,sizeof(r)); } }
+// instance buffer for n shapes: interpolate prev->current, then T*R*S
+static void k_instances_scalar(int n, float* out){
+    for(int i=0;i<n;i++){ mat4 r=compose_trs(g_rt[i].worldPos, anim_orient_lerp(&g_anim, i, 0.4f), SHAPE_SCALE); memcpy(out+i*16,&r,sizeof(r)); }
+}
+static void k_instances_batch(int n, float* out){ TransformJob t={ g_rt, &g_anim, (mat4*)out, 0.4f, 0, 0.0 }; transform_job(&t, 0, n); }
+static void k_hsv2rgb(int n, float* out){ for(int i=0;i<n;i++){ vec3 r=hsv2rgb(g_in.h[i],1.0f,1.0f); memcpy(out+i*3,&r,sizeof(r)); } }
+static void orient_out(int n, float* out){ for(int i=0;i<n;i++){ quat q=anim_orient(&g_anim,i); memcpy(out+i*4,&q,sizeof(q)); } }
+static void k_update_shape(int n, float* out){ for(int i=0;i<n;i++) update_shape(&g_anim, i, 1.0f/60.0f); orient_out(n, out); }
+static void k_update_shapes(int n, float* out){ update_shapes(&g_anim, 0, n, 1.0f/60.0f); orient_out(n, out); }
+static void reset_shapes(void){ anim_copy(&g_anim, &g_animInit); }
+
+typedef void (*BatchFn)(int n, float* out);
+typedef struct {
+    const char* name;
+    BatchFn ref;           // current scalar version
+    BatchFn alt;           // candidate version (NULL = none yet)
+    int outFloats;         // floats written per op
+    void (*reset)(void);   // restores mutable inputs before an error comparison (stateful kernels)
+} Kernel;
+
+static const Kernel KERNELS[] = {
+    { "sincos",       k_sincos_libm,  k_sincos_fast,  2, NULL }, // alt: fast_sincosf
+    { "acos",         k_acos_libm,    k_acos_fast,    1, NULL }, // alt: fast_acosf
+    { "q_slerp",      k_q_slerp_libm, k_q_slerp_fast, 4, NULL }, // alt: q_slerp with fast trig
+    { "q_mul",        k_q_mul,        NULL, 4,  NULL },
+    { "q_from_euler", k_q_from_euler, NULL, 4,  NULL },
+    { "m4_mul",       k_m4_mul,       NULL, 16, NULL },
+    { "m4_from_quat", k_m4_from_quat, NULL, 16, NULL },
+    { "m4_trs",       k_m4_compose,   k_m4_trs, 16, NULL },             // ref: T*R*S via m4_mul
+    { "instances",    k_instances_scalar, k_instances_batch, 16, NULL }, // alt: transform_job (SIMD_NAME)
+    { "hsv2rgb",      k_hsv2rgb,      NULL, 3,  NULL },
+    { "update_shape", k_update_shape, k_update_shapes, 4, reset_shapes }, // alt: SoA batch (SIMD_NAME)
+};
+
+// --------------------------- Measurement ---------------------------
+typedef struct { double mean, ci95; } Timing;
+
+// two-sided 95% Student t quantiles for df=1..30; 1.96 beyond
+static double t95(int df){
+    static const double T[30]={12.706,4.303,3.182,2.776,2.571,2.447,2.365,2.306,2.262,2.228,2.201,2.179,2.160,2.145,2.131,
+                               2.120,2.110,2.101,2.093,2.086,2.080,2.074,2.069,2.064,2.060,2.056,2.052,2.048,2.045,2.042};
+    return df<1? 0.0 : (df<=30? T[df-1] : 1.96);
+}
+
+static volatile float g_sink;
+
+static Timing measure(BatchFn fn, int reps){
+    // warmup ~50 ms, which also calibrates how many batches make a ~20 ms repetition
+    int loops=0; uint64_t t0=now_ns();
+    while(now_ns()-t0 < 50000000u){ fn(g_batch, g_out); loops++; }
+    int perRep = (int)(loops*20.0/50.0); if(perRep<1) perRep=1;
+
+    double* ns = (double*)malloc(sizeof(double)*reps);
+    for(int r=0;r<reps;r++){
+        uint64_t a=now_ns();
+        for(int k=0;k<perRep;k++) fn(g_batch, g_out);
+        uint64_t b=now_ns();
+        ns[r] = (double)(b-a)/((double)perRep*g_batch);
+        g_sink += g_out[r % g_batch]; // keep outputs observable
+    }
+    double mean=0; for(int r=0;r<reps;r++) mean+=ns[r]; mean/=reps;
+    double var=0; for(int r=0;r<reps;r++) var+=(ns[r]-mean)*(ns[r]-mean); var = reps>1? var/(reps-1) : 0.0;
+    free(ns);
+    Timing t = { mean, t95(reps-1)*sqrt(var/reps) };
+    return t;
+}
+
+// Exhaustive-ish sweep against libm (computed in double); returns nonzero if a bound is broken.
+static int accuracy_check(void){
+    double es=0, ec=0, ea=0; float ws=0, wc=0, wa=0;
+    const int N=1<<24;
+    for(int i=0;i<=N;i++){
+        float x = -FAST_TRIG_MAX_ARG + 2*FAST_TRIG_MAX_ARG*(float)((double)i/N), s, c;
+        fast_sincosf(x, &s, &c);
+        double ds=fabs(s-sin((double)x)), dc=fabs(c-cos((double)x));
+        if(ds>es){ es=ds; ws=x; } if(dc>ec){ ec=dc; wc=x; }
+    }
+    for(int i=0;i<=N;i++){ // dense in [-2pi,2pi], where the animation's angles live
+        float x = -2*(float)M_PI + 4*(float)M_PI*(float)((double)i/N), s, c;
+        fast_sincosf(x, &s, &c);
+        double ds=fabs(s-sin((double)x)), dc=fabs(c-cos((double)x));
+        if(ds>es){ es=ds; ws=x; } if(dc>ec){ ec=dc; wc=x; }
+    }
+    for(int i=0;i<=N;i++){
+        float x = -1.0f + 2.0f*(float)((double)i/N);
+        double da=fabs(fast_acosf(x)-acos((double)x)); if(da>ea){ ea=da; wa=x; }
+    }
+    int ok = es<=2e-7 && ec<=2e-7 && ea<=5e-7;
+    printf("accuracy vs libm (double):\n");
+    printf("  sin  |x|<=%g: max |err| %.3g at %.9g (bound 2e-7)\n", FAST_TRIG_MAX_ARG, es, ws);
+    printf("  cos  |x|<=%g: max |err| %.3g at %.9g (bound 2e-7)\n", FAST_TRIG_MAX_ARG, ec, wc);
+    printf("  acos [-1,1]:    max |err| %.3g at %.9g (bound 5e-7)\n", ea, wa);
+    printf("  %s\n", ok? "PASS" : "FAIL");
+    return ok? 0 : 1;
+}
+
+// angle of p*conj(q) in double; 2*acos(dot) loses ~1e-3 rad to float rounding near dot=1
+static double q_angle(quat p, quat q){
+    double w=(double)p.w*q.w+(double)p.x*q.x+(double)p.y*q.y+(double)p.z*q.z;
+    double x=(double)p.x*q.w-(double)p.w*q.x-(double)p.y*q.z+(double)p.z*q.y;
+    double y=(double)p.y*q.w-(double)p.w*q.y-(double)p.z*q.x+(double)p.x*q.z;
+    double z=(double)p.z*q.w-(double)p.w*q.z-(double)p.x*q.y+(double)p.y*q.x;
+    return 2*atan2(sqrt(x*x+y*y+z*z), fabs(w));
+}
+
+// Analytic vs integrated model for the same seed: colour over a long run, orientation over the
+// first hold (t < 4 s, the shortest initial timer). Past that the two draw their keyframe poses
+// from different streams by design, so only the spin and the hue are expected to agree. The
+// integrated step splits the spin into yaw then pitch, which tilts its axis by about
+// spinX*h/2, so the orientation bound is spinX_max*h (first order in h).
+static int model_check(void){
+    enum { SHAPES=256, HZ=60, STEPS=HZ*60, HOLD_STEPS=HZ*39/10 };
+    ShapeAnim a; anim_init(&a, SHAPES, NULL);
+    static float hue0[SHAPES];
+    for(int i=0;i<SHAPES;i++){ anim_spawn_id(&a, i, 12345, (uint32_t)i); hue0[i]=a.hue[i]; }
+    ShapeRuntime R={0}; R.color=COL_RANDOM;
+    double eo=0, ec=0; float h=1.0f/HZ;
+    for(int s=1;s<=STEPS;s++){
+        update_shapes(&a, 0, a.cap, h);
+        double t=(double)s/HZ;
+        for(int i=0;i<SHAPES;i++){
+            if(s<=HOLD_STEPS){
+                double e=q_angle(anim_orient(&a,i), anim_eval(&a,i,t)); if(e>eo) eo=e;
+            }
+            // stepping must leave the hue base alone, so both models see the closed form
+            vec3 c0=color_for(&R, &a, i, t), c1=hsv2rgb((float)fmod((double)hue0[i]+t*(double)a.hueSpeed[i], 1.0), 1.0f, 1.0f);
+            double e=fabs(c0.x-c1.x)+fabs(c0.y-c1.y)+fabs(c0.z-c1.z); if(e>ec) ec=e;
+        }
+    }
+    anim_free(&a);
+    double bound=45.0*M_PI/180.0/HZ;
+    int ok = eo<=bound && ec==0;
+    printf("analytic vs integrated (%d Hz, %d shapes):\n", HZ, SHAPES);
+    printf("  orientation, first hold: max angle %.3g rad (bound %.3g)\n", eo, bound);
+    printf("  colour, %d s:            max |diff| %.3g (bound 0)\n", STEPS/HZ, ec);
+    printf("  %s\n", ok? "PASS" : "FAIL");
+    return ok? 0 : 1;
+}
+
+static double max_abs_error(const Kernel* k){
+    static float ref[MAX_BATCH*16];
+    if(k->reset) k->reset();
+    k->ref(g_batch, ref);
+    if(k->reset) k->reset();
+    k->alt(g_batch, g_out);
+    double err=0; int n=g_batch*k->outFloats;
+    for(int i=0;i<n;i++){ double e=fabs((double)ref[i]-(double)g_out[i]); if(e>err || e!=e) err=e; }
+    return err;
+}
+
+int main(int argc, char** argv){
+    int reps=15; const char* filter=NULL; int accuracy=0;
+    for(int i=1;i<argc;i++){
+        if(strcmp(argv[i],"--reps")==0 && i+1<argc) reps=atoi(argv[++i]);
+        else if(strcmp(argv[i],"--batch")==0 && i+1<argc) g_batch=atoi(argv[++i]);
+        else if(strcmp(argv[i],"--filter")==0 && i+1<argc) filter=argv[++i];
+        else if(strcmp(argv[i],"--accuracy")==0) accuracy=1;
+        else { fprintf(stderr,"usage: %s [--reps R] [--batch N] [--filter substring] [--accuracy]\n", argv[0]); return 1; }
+    }
+    reps=CLAMP(reps,2,1000); g_batch=CLAMP(g_batch,1,MAX_BATCH);
+    if(accuracy) return accuracy_check() | model_check();
+    init_inputs();
+
+    printf("SIMD: %s x%d, batch %d, %d reps\n", SIMD_NAME, SIMD_WIDTH, g_batch, reps);
+    printf("%-14s %20s %20s %8s %12s\n", "kernel", "ref ns/op", "alt ns/op", "speedup", "max |err|");
+    for(int i=0;i<ARRAY_LEN(KERNELS);i++){
+        const Kernel* k=&KERNELS[i];
+        if(filter && !strstr(k->name, filter)) continue;
+        Timing r=measure(k->ref, reps);
+        printf("%-14s %10.3f +- %6.3f", k->name, r.mean, r.ci95);
+        if(k->alt){
+            Timing a=measure(k->alt, reps);
+            printf(" %10.3f +- %6.3f %7.2fx %12.3g\n", a.mean, a.ci95, a.mean>0? r.mean/a.mean : 0.0, max_abs_error(k));
+        } else printf(" %20s %8s %12s\n", "-", "-", "-");
+        if(k->reset) k->reset();
+    }
+    return 0;
+}
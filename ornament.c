@@ -6,23 +6,53 @@
 //  - Transparent background via GLFW_TRANSPARENT_FRAMEBUFFER.
 //  - Wireframe neon glow via multipass line rendering.
 //  - Shapes: CUBE, SPHERE (lat/long + extra rings), PYRAMID, TORUS, OCTAHEDRON.
-//  - INI parsing (simple): SHAPE=[COLOR, POSITION, SCREEN]
-//  - Multi-monitor: one borderless full-size window per SCREEN index used.
-//  - Position anchors with ~6% margins and overlap spiral offsets.
-//  - Fast spin + occasional slow reorientation (quaternion slerp).
+//  - INI parsing (simple): SHAPE=[COLOR, POSITION, SCREEN], plus optional per-shape
+//    LOD=, GLOW=, WIDTH=, SPIN=, SCALE= fields, e.g. SPHERE=[RED, CENTER, 0, LOD=2, GLOW=4]
+//  - Multi-monitor: one borderless full-size window per SCREEN index used; monitors can be
+//    plugged/unplugged at runtime (windows share one GL context's objects).
+//  - Position anchors with ~6% margins; shapes sharing an anchor are packed to minimise
+//    overlap (--layout packed, default) or stepped diagonally (--layout stacked).
+//  - Fast spin + occasional slow reorientation (quaternion slerp), batched SoA/SIMD update.
+//  - Fixed-rate simulation (--sim-hz, default 60) with render-time interpolation.
+//  - Closed-form animation (--anim analytic): orientation is a pure function of time.
+//  - Polynomial sin/cos/acos for the quaternion path (--trig fast|libm, default fast).
 //  - RANDOM color hue cycling (HSV->RGB).
 //  - Icon: embedded tiny green PNG; set where supported.
+//  - Headless mode (--headless [--frames N], default 600 frames; a replay runs its session):
+//    offscreen FBO per screen on EGL surfaceless / OSMesa.
+//  - Run statistics (--stats-json): fps, update/draw ms, edges, peak RSS; see bench.sh.
+//  - Session record/replay (--record / --replay): seed, config hash, screens, timeline options and per-frame dt.
+//  - Work-stealing job pool (--threads N): parallel shape update, transforms, geometry.
+//  - Hot reload: edits to the INI are diffed in live (--no-watch to disable; --watch for headless).
+//  - Compiled scenes: --compile-config ornament.ini -o scene.orn, then --scene scene.orn (mmap, no parsing).
+//  - Frame-phase profiling: --trace out.json writes Chrome trace_event JSON (Perfetto).
+//  - Overdraw heat map (--debug-overdraw): fragments per pixel per window, mean/max and covered-pixel min/mean logged.
+//  - Control socket ($XDG_RUNTIME_DIR/ornament.sock, --control PATH): pause/resume, fps,
+//    brightness, thickness, reload and stats at runtime.
+//  - Shared-memory telemetry (--telemetry NAME): seqlock-guarded per-frame counters, per-window
+//    CPU/GPU frame-time percentiles and memory use; --read-telemetry NAME prints a snapshot.
+//  - Prometheus textfile metrics (--metrics-file PATH [--metrics-interval SEC]) from a background thread.
 //
 // Build (examples):
-//  Linux:   cc -std=c11 ornament.c -lglfw -lGL -ldl -lm -o ornament
+//  Linux:   cc -std=c11 -pthread ornament.c -lglfw -lGL -ldl -lm -lrt -o ornament
 //  macOS:   cc -std=c11 ornament.c -lglfw -framework OpenGL -framework Cocoa -framework IOKit -framework CoreVideo -o ornament
 //  Windows: cl /std:c11 ornament.c /link glfw3.lib opengl32.lib
+//  Meshes:  ./compile.sh first runs gen_meshes.c to bake sphere/torus tables (-DORNAMENT_BAKED_MESHES).
+//  SIMD:    SSE2 (x86-64) / NEON (arm64) by default; add -mavx2 for 8-wide, -DORNAMENT_NO_SIMD for scalar.
+//  Script:  ./compile.sh          (./compile.sh bench also runs the headless scaling benchmark)
 //
 // Notes:
 //  - This is a reasonably compact reference implementation. Some platform quirks
 //    for true desktop-transparency may vary.
 
 #define _CRT_SECURE_NO_WARNINGS
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -33,6 +63,44 @@
 #include <time.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdatomic.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <signal.h>
+#define ORNAMENT_HAS_CONTROL 1   // Unix-domain control socket
+#define ORNAMENT_HAS_TELEMETRY 1 // POSIX shared-memory telemetry
+#endif
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__)
+#define CPU_RELAX() __asm__ __volatile__("yield")
+#else
+#define CPU_RELAX() ((void)0)
+#endif
+#if defined(__unix__) && !defined(__APPLE__)
+#include <dlfcn.h>
+#define ORNAMENT_HAS_HEADLESS 1
+#endif
 
 #include <GLFW/glfw3.h>
 #ifdef __APPLE__
@@ -45,10 +113,334 @@
 // --------------------------- Utility macros ---------------------------
 #define ARRAY_LEN(a) (int)(sizeof(a)/sizeof((a)[0]))
 #define CLAMP(x,a,b) ((x)<(a)?(a):((x)>(b)?(b):(x)))
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+// --------------------------- Timing ---------------------------
+// Monotonic microsecond clock that works before glfwInit (startup phases are timed too).
+static uint64_t time_now_us(void){
+#ifdef _WIN32
+    static LARGE_INTEGER freq; LARGE_INTEGER c; if(!freq.QuadPart) QueryPerformanceFrequency(&freq); QueryPerformanceCounter(&c);
+    return (uint64_t)(c.QuadPart/freq.QuadPart)*1000000u + (uint64_t)(c.QuadPart%freq.QuadPart)*1000000u/(uint64_t)freq.QuadPart;
+#else
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts); return (uint64_t)ts.tv_sec*1000000u + (uint64_t)ts.tv_nsec/1000u;
+#endif
+}
+
+// --------------------------- Trace (Chrome trace_event JSON) ---------------------------
+// --trace out.json: complete ("ph":"X") events are appended to a preallocated per-thread buffer
+// and only serialised by trace_flush() at exit, so recording costs two clock reads per scope.
+// Usage: uint64_t t0=trace_begin(); ...; trace_end("phase", t0);
+#define TRACE_MAX_THREADS 64
+#define TRACE_EVENTS_PER_THREAD (1<<18) // ~8 MB per recording thread; later events are dropped
+
+typedef struct { const char* name; const char* argName; int arg; uint64_t ts, dur; } TraceEvent;
+typedef struct { TraceEvent* ev; int count; int dropped; int tid; const char* threadName; } TraceBuffer;
+
+static struct {
+    const char* path; // NULL = tracing disabled
+    uint64_t t0;
+    TraceBuffer bufs[TRACE_MAX_THREADS];
+    atomic_int nbufs;
+} g_trace;
+static THREAD_LOCAL TraceBuffer* t_traceBuf;
+
+static void trace_init(const char* path){ g_trace.path=path; g_trace.t0=time_now_us(); }
+
+static TraceBuffer* trace_thread_buffer(void){
+    if(!t_traceBuf){
+        static TraceBuffer overflow; // threads past TRACE_MAX_THREADS record nothing
+        int i = atomic_fetch_add(&g_trace.nbufs, 1);
+        if(i<TRACE_MAX_THREADS){
+            TraceBuffer* b=&g_trace.bufs[i]; b->tid=i+1; b->threadName="thread";
+            b->ev=(TraceEvent*)malloc(sizeof(TraceEvent)*TRACE_EVENTS_PER_THREAD);
+            t_traceBuf=b;
+        } else t_traceBuf=&overflow;
+    }
+    return t_traceBuf;
+}
+static void trace_thread_name(const char* name){ if(g_trace.path) trace_thread_buffer()->threadName=name; }
+
+static uint64_t trace_begin(void){ return g_trace.path? time_now_us() : 0; }
+static void trace_end_arg(const char* name, uint64_t t0, const char* argName, int arg){
+    if(!g_trace.path) return;
+    uint64_t t1=time_now_us();
+    TraceBuffer* b=trace_thread_buffer();
+    if(!b->ev || b->count>=TRACE_EVENTS_PER_THREAD){ b->dropped++; return; }
+    TraceEvent* e=&b->ev[b->count++];
+    e->name=name; e->argName=argName; e->arg=arg; e->ts=t0-g_trace.t0; e->dur=t1-t0;
+}
+static void trace_end(const char* name, uint64_t t0){ trace_end_arg(name, t0, NULL, 0); }
+
+// Call once all recording threads have stopped.
+static void trace_flush(void){
+    if(!g_trace.path) return;
+    int n=atomic_load(&g_trace.nbufs); if(n>TRACE_MAX_THREADS) n=TRACE_MAX_THREADS;
+    FILE* f=fopen(g_trace.path,"wb");
+    if(!f) fprintf(stderr,"[ornament] cannot write trace to %s\n", g_trace.path);
+    long total=0, dropped=0;
+    if(f) fprintf(f,"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"ornament\"}}");
+    for(int i=0;i<n;i++){
+        TraceBuffer* b=&g_trace.bufs[i];
+        if(f){
+            fprintf(f,",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", b->tid, b->threadName);
+            for(int k=0;k<b->count;k++){
+                const TraceEvent* e=&b->ev[k];
+                fprintf(f,",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%llu,\"dur\":%llu", e->name, b->tid, (unsigned long long)e->ts, (unsigned long long)e->dur);
+                if(e->argName) fprintf(f,",\"args\":{\"%s\":%d}", e->argName, e->arg);
+                fputc('}', f);
+            }
+        }
+        total+=b->count; dropped+=b->dropped;
+        free(b->ev); b->ev=NULL; b->count=0;
+    }
+    if(f){ fprintf(f,"\n]}\n"); fclose(f); fprintf(stderr,"[ornament] trace: %ld events (%ld dropped) -> %s\n", total, dropped, g_trace.path); }
+}
+
+// --------------------------- Threads ---------------------------
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef SRWLOCK Mutex;
+typedef CONDITION_VARIABLE Cond;
+typedef struct { void (*fn)(void*); void* arg; } ThreadStart;
+static DWORD WINAPI thread_trampoline(LPVOID p){ ThreadStart ts=*(ThreadStart*)p; free(p); ts.fn(ts.arg); return 0; }
+static int thread_start(Thread* t, void (*fn)(void*), void* arg){ ThreadStart* ts=(ThreadStart*)malloc(sizeof(*ts)); ts->fn=fn; ts->arg=arg; *t=CreateThread(NULL,0,thread_trampoline,ts,0,NULL); if(!*t){ free(ts); return 0; } return 1; }
+static void thread_join(Thread t){ WaitForSingleObject(t, INFINITE); CloseHandle(t); }
+static void mutex_init(Mutex* m){ InitializeSRWLock(m); }
+static void mutex_lock(Mutex* m){ AcquireSRWLockExclusive(m); }
+static void mutex_unlock(Mutex* m){ ReleaseSRWLockExclusive(m); }
+static void cond_init(Cond* c){ InitializeConditionVariable(c); }
+static void cond_wait(Cond* c, Mutex* m){ SleepConditionVariableSRW(c, m, INFINITE, 0); }
+static void cond_broadcast(Cond* c){ WakeAllConditionVariable(c); }
+static int cpu_count(void){ SYSTEM_INFO si; GetSystemInfo(&si); return (int)si.dwNumberOfProcessors; }
+#else
+typedef pthread_t Thread;
+typedef pthread_mutex_t Mutex;
+typedef pthread_cond_t Cond;
+typedef struct { void (*fn)(void*); void* arg; } ThreadStart;
+static void* thread_trampoline(void* p){ ThreadStart ts=*(ThreadStart*)p; free(p); ts.fn(ts.arg); return NULL; }
+static int thread_start(Thread* t, void (*fn)(void*), void* arg){ ThreadStart* ts=(ThreadStart*)malloc(sizeof(*ts)); ts->fn=fn; ts->arg=arg; if(pthread_create(t,NULL,thread_trampoline,ts)!=0){ free(ts); return 0; } return 1; }
+static void thread_join(Thread t){ pthread_join(t, NULL); }
+static void mutex_init(Mutex* m){ pthread_mutex_init(m, NULL); }
+static void mutex_lock(Mutex* m){ pthread_mutex_lock(m); }
+static void mutex_unlock(Mutex* m){ pthread_mutex_unlock(m); }
+static void cond_init(Cond* c){ pthread_cond_init(c, NULL); }
+static void cond_wait(Cond* c, Mutex* m){ pthread_cond_wait(c, m); }
+static void cond_broadcast(Cond* c){ pthread_cond_broadcast(c); }
+static int cpu_count(void){ long n=sysconf(_SC_NPROCESSORS_ONLN); return n>0? (int)n : 1; }
+#endif
+
+// --------------------------- Jobs (work-stealing pool) ---------------------------
+// Worker 0 is the calling (main) thread; workers 1..n-1 are pool threads. Each worker owns a
+// deque: the owner pops newest-first from the tail, idle workers steal oldest-first from the
+// head of a victim's deque. Deques are short and touched once per chunk, so a spinlock each is
+// enough. job_parallel_for splits a range into chunks, deals them round-robin over the deques
+// and then helps until every chunk has run.
+#define JOB_MAX_WORKERS 64
+#define JOB_DEQUE_CAP 1024 // power of two; a full deque runs the job inline instead
+
+typedef void (*JobFn)(void* ctx, int begin, int end);
+typedef struct { JobFn fn; void* ctx; int begin, end; const char* name; atomic_int* pending; } Job;
+typedef struct { atomic_flag lock; int head, tail; Job jobs[JOB_DEQUE_CAP]; } JobDeque;
+
+static struct {
+    int workers;            // including the main thread; 1 = run everything inline
+    JobDeque* deques;
+    Thread threads[JOB_MAX_WORKERS];
+    Mutex sleepLock; Cond wake;
+    atomic_int queued;      // jobs sitting in any deque
+    atomic_int quit;
+} g_jobs = { .workers = 1 };
+static THREAD_LOCAL int t_worker; // index of the current thread's deque
+
+static void deque_lock(JobDeque* d){ while(atomic_flag_test_and_set_explicit(&d->lock, memory_order_acquire)) CPU_RELAX(); }
+static void deque_unlock(JobDeque* d){ atomic_flag_clear_explicit(&d->lock, memory_order_release); }
+static int deque_push(JobDeque* d, const Job* j){
+    deque_lock(d); int ok = d->tail - d->head < JOB_DEQUE_CAP; if(ok){ d->jobs[d->tail & (JOB_DEQUE_CAP-1)]=*j; d->tail++; } deque_unlock(d); return ok;
+}
+static int deque_pop(JobDeque* d, Job* j){
+    deque_lock(d); int ok = d->tail > d->head; if(ok){ d->tail--; *j=d->jobs[d->tail & (JOB_DEQUE_CAP-1)]; } deque_unlock(d); return ok;
+}
+static int deque_steal(JobDeque* d, Job* j){
+    deque_lock(d); int ok = d->tail > d->head; if(ok){ *j=d->jobs[d->head & (JOB_DEQUE_CAP-1)]; d->head++; } deque_unlock(d); return ok;
+}
+
+// Own deque first, then every other worker's, starting after ourselves.
+static int job_take(int self, Job* j){
+    if(deque_pop(&g_jobs.deques[self], j)){ atomic_fetch_sub(&g_jobs.queued, 1); return 1; }
+    for(int k=1;k<g_jobs.workers;k++){
+        if(deque_steal(&g_jobs.deques[(self+k) % g_jobs.workers], j)){ atomic_fetch_sub(&g_jobs.queued, 1); return 1; }
+    }
+    return 0;
+}
+
+static void job_run(const Job* j){
+    uint64_t t0=trace_begin();
+    j->fn(j->ctx, j->begin, j->end);
+    trace_end_arg(j->name, t0, "begin", j->begin);
+    atomic_fetch_sub_explicit(j->pending, 1, memory_order_release);
+}
+
+static void job_worker_main(void* arg){
+    t_worker=(int)(intptr_t)arg;
+    trace_thread_name("worker");
+    while(!atomic_load(&g_jobs.quit)){
+        Job j;
+        if(job_take(t_worker, &j)){ job_run(&j); continue; }
+        int spins=0;
+        while(atomic_load(&g_jobs.queued)==0 && spins<2000 && !atomic_load(&g_jobs.quit)){ CPU_RELAX(); spins++; }
+        if(atomic_load(&g_jobs.queued)>0) continue;
+        mutex_lock(&g_jobs.sleepLock);
+        while(atomic_load(&g_jobs.queued)==0 && !atomic_load(&g_jobs.quit)) cond_wait(&g_jobs.wake, &g_jobs.sleepLock);
+        mutex_unlock(&g_jobs.sleepLock);
+    }
+}
+
+// threads<=0: one worker per CPU.
+static void job_init(int threads){
+    if(threads<=0) threads=cpu_count();
+    threads=CLAMP(threads,1,JOB_MAX_WORKERS);
+    g_jobs.deques=(JobDeque*)calloc((size_t)threads, sizeof(JobDeque));
+    for(int i=0;i<threads;i++) atomic_flag_clear(&g_jobs.deques[i].lock);
+    mutex_init(&g_jobs.sleepLock); cond_init(&g_jobs.wake);
+    atomic_init(&g_jobs.queued, 0); atomic_init(&g_jobs.quit, 0);
+    g_jobs.workers=1; t_worker=0;
+    for(int i=1;i<threads;i++){ if(!thread_start(&g_jobs.threads[i], job_worker_main, (void*)(intptr_t)i)) break; g_jobs.workers++; }
+}
+
+static void job_shutdown(void){
+    if(!g_jobs.deques) return;
+    mutex_lock(&g_jobs.sleepLock); atomic_store(&g_jobs.quit, 1); cond_broadcast(&g_jobs.wake); mutex_unlock(&g_jobs.sleepLock);
+    for(int i=1;i<g_jobs.workers;i++) thread_join(g_jobs.threads[i]);
+    free(g_jobs.deques); g_jobs.deques=NULL; g_jobs.workers=1;
+}
+
+// Runs fn over [0,count) in chunks of `grain` (the last may be shorter); returns when all are done.
+static void job_parallel_for(const char* name, int count, int grain, JobFn fn, void* ctx){
+    if(count<=0) return;
+    if(grain<1) grain=1;
+    if(g_jobs.workers<=1 || count<=grain){ uint64_t t0=trace_begin(); fn(ctx, 0, count); trace_end_arg(name, t0, "begin", 0); return; }
+    int chunks=(count+grain-1)/grain;
+    atomic_int pending; atomic_init(&pending, chunks);
+    for(int c=0;c<chunks;c++){
+        Job j={ fn, ctx, c*grain, (c+1)*grain<count? (c+1)*grain : count, name, &pending };
+        if(deque_push(&g_jobs.deques[(t_worker+c) % g_jobs.workers], &j)) atomic_fetch_add(&g_jobs.queued, 1);
+        else job_run(&j);
+    }
+    mutex_lock(&g_jobs.sleepLock); cond_broadcast(&g_jobs.wake); mutex_unlock(&g_jobs.sleepLock);
+    while(atomic_load_explicit(&pending, memory_order_acquire)>0){ Job j; if(job_take(t_worker, &j)) job_run(&j); else CPU_RELAX(); }
+}
+
+// Chunk size giving each worker a few chunks, rounded to `align`, never below `minGrain`.
+static int job_grain(int count, int minGrain, int align){
+    int g=count/(g_jobs.workers*4); if(g<minGrain) g=minGrain;
+    return (g+align-1)/align*align;
+}
+
+// --------------------------- Arenas ---------------------------
+// Bump allocator over a chain of blocks: config, meshes and runtime state are carved out of a
+// few contiguous blocks and released together by arena_free. Not thread-safe; parallel jobs
+// use one arena per worker. g_arenaReserved totals the bytes held by all arenas (--stats-json).
+#define ARENA_BLOCK_SIZE (64*1024)
+
+typedef struct ArenaBlock { struct ArenaBlock* next; size_t size, used; } ArenaBlock; // data follows the header
+typedef struct { ArenaBlock* head; size_t reserved, used; int blocks; } Arena;
+static atomic_llong g_arenaReserved;
+
+static size_t arena_align_up(size_t x, size_t align){ return (x + align-1) & ~(align-1); }
+#define ARENA_HEADER arena_align_up(sizeof(ArenaBlock), 64)
+
+// align must be a power of two <= 64. Returns uninitialised memory, or NULL when out of memory.
+static void* arena_alloc(Arena* a, size_t size, size_t align){
+    ArenaBlock* b=a->head;
+    size_t at = b? arena_align_up(b->used, align) : 0;
+    if(!b || at+size > b->size){
+        size_t cap = size > ARENA_BLOCK_SIZE? size : ARENA_BLOCK_SIZE;
+        b = (ArenaBlock*)malloc(ARENA_HEADER + cap); if(!b) return NULL;
+        b->next=a->head; b->size=cap; b->used=0; a->head=b; at=0;
+        a->reserved += ARENA_HEADER + cap; a->blocks++; atomic_fetch_add(&g_arenaReserved, (long long)(ARENA_HEADER + cap));
+    }
+    b->used = at+size; a->used += size;
+    return (char*)b + ARENA_HEADER + at;
+}
+static void* arena_calloc(Arena* a, size_t n, size_t size, size_t align){ void* p=arena_alloc(a, n*size, align); if(p) memset(p, 0, n*size); return p; }
+
+static void arena_free(Arena* a){
+    atomic_fetch_sub(&g_arenaReserved, (long long)a->reserved);
+    for(ArenaBlock* b=a->head; b;){ ArenaBlock* n=b->next; free(b); b=n; }
+    memset(a, 0, sizeof(*a));
+}
 
 // --------------------------- Random ---------------------------
-static float frand01(void){ return (float)rand()/(float)RAND_MAX; }
-static float frand_range(float a,float b){ return a + (b-a)*frand01(); }
+// xoshiro128** per shape, seeded through splitmix64 from the global --seed: runs are repeatable
+// and shapes share no hidden state, so they can be updated from any thread.
+typedef struct { uint32_t s[4]; } Rng;
+
+static uint64_t splitmix64(uint64_t* x){
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z>>30)) * 0xBF58476D1CE4E5B9ull; z = (z ^ (z>>27)) * 0x94D049BB133111EBull;
+    return z ^ (z>>31);
+}
+static Rng rng_seed(uint64_t seed, uint64_t stream){
+    uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ull);
+    uint64_t a = splitmix64(&x), b = splitmix64(&x);
+    Rng r = {{ (uint32_t)a, (uint32_t)(a>>32), (uint32_t)b, (uint32_t)(b>>32) }};
+    if(!(r.s[0]|r.s[1]|r.s[2]|r.s[3])) r.s[0]=1; // all-zero state is a fixed point
+    return r;
+}
+static uint32_t rng_next(Rng* r){
+    uint32_t* s=r->s; uint32_t x=s[1]*5u; uint32_t out=((x<<7)|(x>>25))*9u;
+    uint32_t t=s[1]<<9;
+    s[2]^=s[0]; s[3]^=s[1]; s[1]^=s[2]; s[0]^=s[3]; s[2]^=t; s[3]=(s[3]<<11)|(s[3]>>21);
+    return out;
+}
+static float rng_float01(Rng* r){ return (float)(rng_next(r)>>8) * (1.0f/16777216.0f); } // [0,1)
+static float rng_range(Rng* r, float a, float b){ return a + (b-a)*rng_float01(r); }
+
+// --------------------------- Fast trig ---------------------------
+// Scalar twins of vf_sincos/vf_acos (Cephes polynomials) for the per-shape quaternion code.
+// Cheaper than libm: inlined, no errno or huge-argument reduction, one reduction for sin and
+// cos. Error vs libm (checked by `microbench --accuracy`): sin/cos <= 2e-7 abs for |x| <= 8192,
+// acos <= 5e-7 abs on [-1,1]. --trig libm (or building with -DORNAMENT_LIBM_TRIG) switches the
+// scalar paths back to libm; the SIMD batch kernels always use the polynomials.
+#define FAST_TRIG_MAX_ARG 8192.0f
+#ifdef ORNAMENT_LIBM_TRIG
+static int g_trigLibm = 1;
+#else
+static int g_trigLibm = 0;
+#endif
+
+static inline void fast_sincosf(float x, float* s, float* c){
+    float ax = fabsf(x);
+    int j = (int)(ax*1.27323954473516f); j = (j+1) & ~1; // octant, rounded up to even
+    float fj = (float)j;
+    float y = ((ax - fj*0.78515625f) - fj*2.4187564849853515625e-4f) - fj*3.77489497744594108e-8f;
+    float z = y*y;
+    float pc = ((2.443315711809948e-5f*z - 1.388731625493765e-3f)*z + 4.166664568298827e-2f)*z*z - 0.5f*z + 1.0f;
+    float ps = ((-1.9515295891e-4f*z + 8.3321608736e-3f)*z - 1.6666654611e-1f)*z*y + y;
+    int j8 = j & 7;
+    float sv = (j8==0 || j8==4)? ps : pc, cv = (j8==0 || j8==4)? pc : ps;
+    *s = ((x<0) != (j8>=4))? -sv : sv;
+    *c = (j8==2 || j8==4)? -cv : cv;
+}
+
+static inline float fast_acosf(float x){
+    float ax = fabsf(x), z, sx;
+    int big = ax > 0.5f;
+    if(big){ z = 0.5f*(1.0f-ax); sx = sqrtf(z); } else { z = ax*ax; sx = ax; }
+    float p = (((4.2163199048e-2f*z + 2.4181311049e-2f)*z + 4.5470025998e-2f)*z + 7.4953002686e-2f)*z + 1.6666752422e-1f;
+    float as = p*z*sx + sx;
+    float r = big? as+as : (float)M_PI*0.5f - as;
+    return x<0? (float)M_PI - r : r;
+}
+
+static inline void trig_sincos(float x, float* s, float* c){
+    if(g_trigLibm || fabsf(x) > FAST_TRIG_MAX_ARG){ *s=sinf(x); *c=cosf(x); } else fast_sincosf(x, s, c);
+}
+static inline float trig_acos(float x){ return g_trigLibm? acosf(x) : fast_acosf(x); }
 
 // --------------------------- Vec/Mat/Quat ---------------------------
 typedef struct { float x,y; } vec2;
@@ -66,7 +458,7 @@ static float v3_len(vec3 a){ return sqrtf(v3_dot(a,a)); }
 static vec3 v3_norm(vec3 a){ float l=v3_len(a); return l>1e-8f? v3_scale(a,1.0f/l):v3(0,0,0);}
 
 static quat q_ident(void){ quat q={0,0,0,1}; return q; }
-static quat q_from_axis_angle(vec3 axis, float rad){ axis=v3_norm(axis); float s=sinf(rad*0.5f); quat q={axis.x*s,axis.y*s,axis.z*s,cosf(rad*0.5f)}; return q; }
+static quat q_from_axis_angle(vec3 axis, float rad){ axis=v3_norm(axis); float s,c; trig_sincos(rad*0.5f,&s,&c); quat q={axis.x*s,axis.y*s,axis.z*s,c}; return q; }
 static quat q_mul(quat a, quat b){
     quat r;
     r.w = a.w*b.w - a.x*b.x - a.y*b.y - a.z*b.z;
@@ -76,9 +468,8 @@ static quat q_mul(quat a, quat b){
     return r;
 }
 static quat q_from_euler(float pitch,float yaw,float roll){ // XYZ (pitch=X,yaw=Y,roll=Z)
-    float cx=cosf(pitch*0.5f), sx=sinf(pitch*0.5f);
-    float cy=cosf(yaw*0.5f),   sy=sinf(yaw*0.5f);
-    float cz=cosf(roll*0.5f),  sz=sinf(roll*0.5f);
+    float cx,sx,cy,sy,cz,sz;
+    trig_sincos(pitch*0.5f,&sx,&cx); trig_sincos(yaw*0.5f,&sy,&cy); trig_sincos(roll*0.5f,&sz,&cz);
     quat q;
     q.w = cx*cy*cz + sx*sy*sz;
     q.x = sx*cy*cz - cx*sy*sz;
@@ -87,29 +478,22 @@ static quat q_from_euler(float pitch,float yaw,float roll){ // XYZ (pitch=X,yaw=
     return q;
 }
 static quat q_norm(quat q){ float l=sqrtf(q.x*q.x+q.y*q.y+q.z*q.z+q.w*q.w); if(l<1e-8f) return q_ident(); float il=1.0f/l; q.x*=il;q.y*=il;q.z*=il;q.w*=il; return q; }
-static quat q_slerp(quat a, quat b, float t){
-    a=q_norm(a); b=q_norm(b);
-    float dot=a.x*b.x + a.y*b.y + a.z*b.z + a.w*b.w;
-    if(dot<0){ b.x=-b.x; b.y=-b.y; b.z=-b.z; b.w=-b.w; dot=-dot; }
-    if(dot>0.9995f){ // lerp
-        quat r={ a.x + t*(b.x-a.x), a.y + t*(b.y-a.y), a.z + t*(b.z-a.z), a.w + t*(b.w-a.w)}; return q_norm(r);
-    }
-    float th = acosf(dot);
-    float s1 = sinf((1-t)*th)/sinf(th);
-    float s2 = sinf(t*th)/sinf(th);
-    quat r={ a.x*s1 + b.x*s2, a.y*s1 + b.y*s2, a.z*s1 + b.z*s2, a.w*s1 + b.w*s2 };
-    return r;
-}
 static mat4 m4_ident(void){ mat4 m={{1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1}}; return m; }
-static mat4 m4_mul(mat4 a, mat4 b){ mat4 r; for(int i=0;i<4;i++) for(int j=0;j<4;j++){ r.m[i*4+j]=0; for(int k=0;k<4;k++) r.m[i*4+j]+=a.m[i*4+k]*b.m[k*4+j]; } return r; }
-static mat4 m4_translate(vec3 t){ mat4 m=m4_ident(); m.m[12]=t.x; m.m[13]=t.y; m.m[14]=t.z; return m; }
 static mat4 m4_scale(float s){ mat4 m=m4_ident(); m.m[0]=m.m[5]=m.m[10]=s; return m; }
 static mat4 m4_perspective(float fovy,float aspect,float znear,float zfar){ float f=1.0f/tanf(fovy*0.5f); mat4 m={{0}}; m.m[0]=f/aspect; m.m[5]=f; m.m[10]=(zfar+znear)/(znear-zfar); m.m[11]=-1.0f; m.m[14]=(2*zfar*znear)/(znear-zfar); return m; }
 static mat4 m4_lookat(vec3 eye, vec3 center, vec3 up){ vec3 f=v3_norm(v3_sub(center,eye)); vec3 s=v3_norm(v3_cross(f,up)); vec3 u=v3_cross(s,f); mat4 m=m4_ident(); m.m[0]=s.x; m.m[4]=s.y; m.m[8]=s.z; m.m[1]=u.x; m.m[5]=u.y; m.m[9]=u.z; m.m[2]=-f.x; m.m[6]=-f.y; m.m[10]=-f.z; m.m[12]=-v3_dot(s,eye); m.m[13]=-v3_dot(u,eye); m.m[14]=v3_dot(f,eye); return m; }
-static mat4 m4_from_quat(quat q){ q=q_norm(q); float x=q.x,y=q.y,z=q.z,w=q.w; mat4 m=m4_ident();
-    m.m[0]=1-2*y*y-2*z*z; m.m[1]=2*x*y+2*w*z;   m.m[2]=2*x*z-2*w*y;
-    m.m[4]=2*x*y-2*w*z;   m.m[5]=1-2*x*x-2*z*z; m.m[6]=2*y*z+2*w*x;
-    m.m[8]=2*x*z+2*w*y;   m.m[9]=2*y*z-2*w*x;   m.m[10]=1-2*x*x-2*y*y; return m; }
+// T*R*S in one pass: translation t, rotation q, uniform scale s, column-major like the rest.
+// q need not be unit length; k=2s/|q|^2 folds the normalisation in without a sqrt.
+static mat4 m4_trs(vec3 t, quat q, float s){
+    float x=q.x,y=q.y,z=q.z,w=q.w, n=x*x+y*y+z*z+w*w;
+    if(n<1e-16f){ mat4 m=m4_scale(s); m.m[12]=t.x; m.m[13]=t.y; m.m[14]=t.z; return m; }
+    float k=2.0f*s/n;
+    mat4 m={{ s-k*(y*y+z*z), k*(x*y+w*z),   k*(x*z-w*y),   0,
+              k*(x*y-w*z),   s-k*(x*x+z*z), k*(y*z+w*x),   0,
+              k*(x*z+w*y),   k*(y*z-w*x),   s-k*(x*x+y*y), 0,
+              t.x,           t.y,           t.z,           1 }};
+    return m;
+}
 
 // --------------------------- HSV->RGB ---------------------------
 static vec3 hsv2rgb(float h,float s,float v){ // h in [0,1)
@@ -122,6 +506,213 @@ static vec3 hsv2rgb(float h,float s,float v){ // h in [0,1)
     } return r;
 }
 
+// --------------------------- SIMD ---------------------------
+// Minimal float-vector layer for the batched kernels; width fixed at compile time:
+// AVX2 (8 lanes), SSE2 or AArch64 NEON (4), otherwise scalar (1). vm is a per-lane mask.
+#if !defined(ORNAMENT_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define SIMD_WIDTH 8
+#define SIMD_NAME "AVX2"
+typedef __m256 vf; typedef __m256 vm;
+static inline vf vf_set1(float x){ return _mm256_set1_ps(x); }
+static inline vf vf_load(const float* p){ return _mm256_load_ps(p); }
+static inline void vf_store(float* p, vf a){ _mm256_store_ps(p,a); }
+static inline vf vf_add(vf a, vf b){ return _mm256_add_ps(a,b); }
+static inline vf vf_sub(vf a, vf b){ return _mm256_sub_ps(a,b); }
+static inline vf vf_mul(vf a, vf b){ return _mm256_mul_ps(a,b); }
+static inline vf vf_div(vf a, vf b){ return _mm256_div_ps(a,b); }
+static inline vf vf_sqrt(vf a){ return _mm256_sqrt_ps(a); }
+static inline vf vf_min(vf a, vf b){ return _mm256_min_ps(a,b); }
+static inline vf vf_max(vf a, vf b){ return _mm256_max_ps(a,b); }
+static inline vf vf_floor(vf a){ return _mm256_floor_ps(a); }
+static inline vm vf_lt(vf a, vf b){ return _mm256_cmp_ps(a,b,_CMP_LT_OQ); }
+static inline vm vf_le(vf a, vf b){ return _mm256_cmp_ps(a,b,_CMP_LE_OQ); }
+static inline vm vf_eq(vf a, vf b){ return _mm256_cmp_ps(a,b,_CMP_EQ_OQ); }
+static inline vm vm_and(vm a, vm b){ return _mm256_and_ps(a,b); }
+static inline vm vm_or(vm a, vm b){ return _mm256_or_ps(a,b); }
+static inline vm vm_xor(vm a, vm b){ return _mm256_xor_ps(a,b); }
+static inline vm vm_andnot(vm a, vm b){ return _mm256_andnot_ps(b,a); } // a & ~b
+static inline vf vf_sel(vm m, vf a, vf b){ return _mm256_blendv_ps(b,a,m); }
+static inline int vm_bits(vm m){ return _mm256_movemask_ps(m); }
+#elif !defined(ORNAMENT_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define SIMD_WIDTH 4
+#define SIMD_NAME "SSE2"
+typedef __m128 vf; typedef __m128 vm;
+static inline vf vf_set1(float x){ return _mm_set1_ps(x); }
+static inline vf vf_load(const float* p){ return _mm_load_ps(p); }
+static inline void vf_store(float* p, vf a){ _mm_store_ps(p,a); }
+static inline vf vf_add(vf a, vf b){ return _mm_add_ps(a,b); }
+static inline vf vf_sub(vf a, vf b){ return _mm_sub_ps(a,b); }
+static inline vf vf_mul(vf a, vf b){ return _mm_mul_ps(a,b); }
+static inline vf vf_div(vf a, vf b){ return _mm_div_ps(a,b); }
+static inline vf vf_sqrt(vf a){ return _mm_sqrt_ps(a); }
+static inline vf vf_min(vf a, vf b){ return _mm_min_ps(a,b); }
+static inline vf vf_max(vf a, vf b){ return _mm_max_ps(a,b); }
+static inline vf vf_floor(vf a){ vf t=_mm_cvtepi32_ps(_mm_cvttps_epi32(a)); return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t,a), _mm_set1_ps(1.0f))); } // |a| < 2^31
+static inline vm vf_lt(vf a, vf b){ return _mm_cmplt_ps(a,b); }
+static inline vm vf_le(vf a, vf b){ return _mm_cmple_ps(a,b); }
+static inline vm vf_eq(vf a, vf b){ return _mm_cmpeq_ps(a,b); }
+static inline vm vm_and(vm a, vm b){ return _mm_and_ps(a,b); }
+static inline vm vm_or(vm a, vm b){ return _mm_or_ps(a,b); }
+static inline vm vm_xor(vm a, vm b){ return _mm_xor_ps(a,b); }
+static inline vm vm_andnot(vm a, vm b){ return _mm_andnot_ps(b,a); } // a & ~b
+static inline vf vf_sel(vm m, vf a, vf b){ return _mm_or_ps(_mm_and_ps(m,a), _mm_andnot_ps(m,b)); }
+static inline int vm_bits(vm m){ return _mm_movemask_ps(m); }
+#elif !defined(ORNAMENT_NO_SIMD) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SIMD_WIDTH 4
+#define SIMD_NAME "NEON"
+typedef float32x4_t vf; typedef uint32x4_t vm;
+static inline vf vf_set1(float x){ return vdupq_n_f32(x); }
+static inline vf vf_load(const float* p){ return vld1q_f32(p); }
+static inline void vf_store(float* p, vf a){ vst1q_f32(p,a); }
+static inline vf vf_add(vf a, vf b){ return vaddq_f32(a,b); }
+static inline vf vf_sub(vf a, vf b){ return vsubq_f32(a,b); }
+static inline vf vf_mul(vf a, vf b){ return vmulq_f32(a,b); }
+static inline vf vf_div(vf a, vf b){ return vdivq_f32(a,b); }
+static inline vf vf_sqrt(vf a){ return vsqrtq_f32(a); }
+static inline vf vf_min(vf a, vf b){ return vminq_f32(a,b); }
+static inline vf vf_max(vf a, vf b){ return vmaxq_f32(a,b); }
+static inline vf vf_floor(vf a){ return vrndmq_f32(a); }
+static inline vm vf_lt(vf a, vf b){ return vcltq_f32(a,b); }
+static inline vm vf_le(vf a, vf b){ return vcleq_f32(a,b); }
+static inline vm vf_eq(vf a, vf b){ return vceqq_f32(a,b); }
+static inline vm vm_and(vm a, vm b){ return vandq_u32(a,b); }
+static inline vm vm_or(vm a, vm b){ return vorrq_u32(a,b); }
+static inline vm vm_xor(vm a, vm b){ return veorq_u32(a,b); }
+static inline vm vm_andnot(vm a, vm b){ return vbicq_u32(a,b); } // a & ~b
+static inline vf vf_sel(vm m, vf a, vf b){ return vbslq_f32(m,a,b); }
+static inline int vm_bits(vm m){ static const uint32_t bit[4]={1,2,4,8}; return (int)vaddvq_u32(vandq_u32(m, vld1q_u32(bit))); }
+#else
+#define SIMD_WIDTH 1
+#define SIMD_NAME "scalar"
+typedef float vf; typedef int vm;
+static inline vf vf_set1(float x){ return x; }
+static inline vf vf_load(const float* p){ return *p; }
+static inline void vf_store(float* p, vf a){ *p=a; }
+static inline vf vf_add(vf a, vf b){ return a+b; }
+static inline vf vf_sub(vf a, vf b){ return a-b; }
+static inline vf vf_mul(vf a, vf b){ return a*b; }
+static inline vf vf_div(vf a, vf b){ return a/b; }
+static inline vf vf_sqrt(vf a){ return sqrtf(a); }
+static inline vf vf_min(vf a, vf b){ return a<b? a : b; }
+static inline vf vf_max(vf a, vf b){ return a>b? a : b; }
+static inline vf vf_floor(vf a){ return floorf(a); }
+static inline vm vf_lt(vf a, vf b){ return a<b; }
+static inline vm vf_le(vf a, vf b){ return a<=b; }
+static inline vm vf_eq(vf a, vf b){ return a==b; }
+static inline vm vm_and(vm a, vm b){ return a&b; }
+static inline vm vm_or(vm a, vm b){ return a|b; }
+static inline vm vm_xor(vm a, vm b){ return a^b; }
+static inline vm vm_andnot(vm a, vm b){ return a&!b; }
+static inline vf vf_sel(vm m, vf a, vf b){ return m? a : b; }
+static inline int vm_bits(vm m){ return m; }
+#endif
+#define SIMD_ALIGN 32 // bytes; enough for every width above
+#define SIMD_ALIGNED _Alignas(SIMD_ALIGN)
+
+static inline vf vf_neg(vf a){ return vf_sub(vf_set1(0.0f), a); }
+static inline vm vf_gt(vf a, vf b){ return vf_lt(b,a); }
+static inline vm vf_ge(vf a, vf b){ return vf_le(b,a); }
+
+// sin and cos together (Cephes sincosf polynomials, ~1 ulp for |x| < 8192), branch-free;
+// lane-wise identical to fast_sincosf
+static inline void vf_sincos(vf x, vf* s, vf* c){
+    const vf zero=vf_set1(0.0f), one=vf_set1(1.0f), half=vf_set1(0.5f);
+    vm neg = vf_lt(x, zero); vf ax = vf_max(x, vf_neg(x));
+    // octant j, rounded up to even; j mod 8 picks polynomial and signs
+    vf j = vf_floor(vf_mul(ax, vf_set1(1.27323954473516f)));
+    j = vf_mul(vf_set1(2.0f), vf_floor(vf_mul(vf_add(j, one), half)));
+    vf y = vf_sub(vf_sub(vf_sub(ax, vf_mul(j, vf_set1(0.78515625f))), vf_mul(j, vf_set1(2.4187564849853515625e-4f))), vf_mul(j, vf_set1(3.77489497744594108e-8f)));
+    vf j8 = vf_sub(j, vf_mul(vf_set1(8.0f), vf_floor(vf_mul(j, vf_set1(0.125f)))));
+    vm sinPoly = vm_or(vf_eq(j8, zero), vf_eq(j8, vf_set1(4.0f)));
+    vm sinNeg = vm_xor(neg, vf_ge(j8, vf_set1(4.0f)));
+    vm cosNeg = vm_or(vf_eq(j8, vf_set1(2.0f)), vf_eq(j8, vf_set1(4.0f)));
+    vf z = vf_mul(y, y);
+    vf pc = vf_add(vf_sub(vf_mul(vf_mul(vf_add(vf_mul(vf_add(vf_mul(vf_set1(2.443315711809948e-5f), z), vf_set1(-1.388731625493765e-3f)), z), vf_set1(4.166664568298827e-2f)), z), z), vf_mul(half, z)), one);
+    vf ps = vf_add(vf_mul(vf_mul(vf_add(vf_mul(vf_add(vf_mul(vf_set1(-1.9515295891e-4f), z), vf_set1(8.3321608736e-3f)), z), vf_set1(-1.6666654611e-1f)), z), y), y);
+    vf sv = vf_sel(sinPoly, ps, pc), cv = vf_sel(sinPoly, pc, ps);
+    *s = vf_sel(sinNeg, vf_neg(sv), sv);
+    *c = vf_sel(cosNeg, vf_neg(cv), cv);
+}
+
+// acos on [-1,1] via Cephes asinf: acos(|x|) = x>0.5 ? 2*asin(sqrt((1-x)/2)) : pi/2 - asin(x)
+static inline vf vf_acos(vf x){
+    const vf half=vf_set1(0.5f);
+    vf ax = vf_max(x, vf_neg(x));
+    vm big = vf_gt(ax, half);
+    vf z = vf_sel(big, vf_mul(half, vf_sub(vf_set1(1.0f), ax)), vf_mul(ax, ax));
+    vf sx = vf_sel(big, vf_sqrt(z), ax);
+    vf p = vf_add(vf_mul(vf_set1(4.2163199048e-2f), z), vf_set1(2.4181311049e-2f));
+    p = vf_add(vf_mul(p, z), vf_set1(4.5470025998e-2f)); p = vf_add(vf_mul(p, z), vf_set1(7.4953002686e-2f)); p = vf_add(vf_mul(p, z), vf_set1(1.6666752422e-1f));
+    vf as = vf_add(vf_mul(vf_mul(p, z), sx), sx);
+    vf r = vf_sel(big, vf_add(as, as), vf_sub(vf_set1((float)M_PI*0.5f), as));
+    return vf_sel(vf_lt(x, vf_set1(0.0f)), vf_sub(vf_set1((float)M_PI), r), r);
+}
+
+typedef struct { vf x,y,z,w; } vquat;
+static inline vquat vq_sel(vm m, vquat a, vquat b){ vquat r={ vf_sel(m,a.x,b.x), vf_sel(m,a.y,b.y), vf_sel(m,a.z,b.z), vf_sel(m,a.w,b.w) }; return r; }
+static inline vf vq_dot(vquat a, vquat b){ return vf_add(vf_add(vf_mul(a.x,b.x), vf_mul(a.y,b.y)), vf_add(vf_mul(a.z,b.z), vf_mul(a.w,b.w))); }
+static inline vquat vq_scale(vquat a, vf s){ vquat r={ vf_mul(a.x,s), vf_mul(a.y,s), vf_mul(a.z,s), vf_mul(a.w,s) }; return r; }
+static inline vquat vq_norm(vquat q){ // as q_norm: identity for degenerate lanes
+    vf l2 = vq_dot(q,q); vm tiny = vf_lt(l2, vf_set1(1e-16f));
+    vquat r = vq_scale(q, vf_div(vf_set1(1.0f), vf_sqrt(vf_max(l2, vf_set1(1e-16f)))));
+    vquat id = { vf_set1(0), vf_set1(0), vf_set1(0), vf_set1(1) };
+    return vq_sel(tiny, id, r);
+}
+static inline vquat vq_mul(vquat a, vquat b){
+    vquat r;
+    r.w = vf_sub(vf_sub(vf_sub(vf_mul(a.w,b.w), vf_mul(a.x,b.x)), vf_mul(a.y,b.y)), vf_mul(a.z,b.z));
+    r.x = vf_sub(vf_add(vf_add(vf_mul(a.w,b.x), vf_mul(a.x,b.w)), vf_mul(a.y,b.z)), vf_mul(a.z,b.y));
+    r.y = vf_add(vf_add(vf_sub(vf_mul(a.w,b.y), vf_mul(a.x,b.z)), vf_mul(a.y,b.w)), vf_mul(a.z,b.x));
+    r.z = vf_add(vf_sub(vf_add(vf_mul(a.w,b.z), vf_mul(a.x,b.y)), vf_mul(a.y,b.x)), vf_mul(a.z,b.w));
+    return r;
+}
+// Quaternion slerp per lane (scalar reference: q_slerp in microbench.c); the lerp branch
+// (dot > 0.9995) is picked by mask. With th=acos(dot): sin(th)=sqrt((1-dot)(1+dot)) and
+// sin((1-t)th)=sin(th)cos(t*th)-dot*sin(t*th), so one sincos replaces three sinf calls.
+static inline vquat vq_slerp(vquat a, vquat b, vf t){
+    const vf one=vf_set1(1.0f);
+    a=vq_norm(a); b=vq_norm(b);
+    vf dot=vq_dot(a,b);
+    vm flip=vf_lt(dot, vf_set1(0.0f));
+    b=vq_sel(flip, vq_scale(b, vf_set1(-1.0f)), b); dot=vf_sel(flip, vf_neg(dot), dot);
+    vm lerp=vf_gt(dot, vf_set1(0.9995f)); int lerpBits=vm_bits(lerp);
+    vquat r=a, l=a;
+    if(lerpBits != (1<<SIMD_WIDTH)-1){
+        vf th=vf_acos(vf_min(dot, one));
+        vf ist=vf_div(one, vf_max(vf_sqrt(vf_mul(vf_sub(one,dot), vf_add(one,dot))), vf_set1(1e-6f))); // lerp lanes may reach 0; discarded
+        vf st, ct; vf_sincos(vf_mul(t, th), &st, &ct);
+        vf s2=vf_mul(st, ist), s1=vf_sub(ct, vf_mul(dot, s2));
+        r=(vquat){ vf_add(vf_mul(a.x,s1), vf_mul(b.x,s2)), vf_add(vf_mul(a.y,s1), vf_mul(b.y,s2)), vf_add(vf_mul(a.z,s1), vf_mul(b.z,s2)), vf_add(vf_mul(a.w,s1), vf_mul(b.w,s2)) };
+    }
+    if(lerpBits){
+        l=(vquat){ vf_add(a.x, vf_mul(t, vf_sub(b.x,a.x))), vf_add(a.y, vf_mul(t, vf_sub(b.y,a.y))), vf_add(a.z, vf_mul(t, vf_sub(b.z,a.z))), vf_add(a.w, vf_mul(t, vf_sub(b.w,a.w))) };
+        l=vq_norm(l);
+    }
+    return vq_sel(lerp, l, r);
+}
+
+// m4_trs for SIMD_WIDTH shapes; writes the first `lanes` matrices to out[0..lanes).
+static inline void vm4_trs_store(vquat q, vf tx, vf ty, vf tz, vf s, mat4* out, int lanes){
+    vf xx=vf_mul(q.x,q.x), yy=vf_mul(q.y,q.y), zz=vf_mul(q.z,q.z);
+    vf xy=vf_mul(q.x,q.y), xz=vf_mul(q.x,q.z), yz=vf_mul(q.y,q.z), wx=vf_mul(q.w,q.x), wy=vf_mul(q.w,q.y), wz=vf_mul(q.w,q.z);
+    vf k=vf_div(vf_add(s,s), vf_max(vf_add(vf_add(xx,yy), vf_add(zz, vf_mul(q.w,q.w))), vf_set1(1e-16f)));
+    SIMD_ALIGNED float m[12][SIMD_WIDTH];
+    vf_store(m[0], vf_sub(s, vf_mul(k, vf_add(yy,zz)))); vf_store(m[1], vf_mul(k, vf_add(xy,wz))); vf_store(m[2], vf_mul(k, vf_sub(xz,wy)));
+    vf_store(m[3], vf_mul(k, vf_sub(xy,wz))); vf_store(m[4], vf_sub(s, vf_mul(k, vf_add(xx,zz)))); vf_store(m[5], vf_mul(k, vf_add(yz,wx)));
+    vf_store(m[6], vf_mul(k, vf_add(xz,wy))); vf_store(m[7], vf_mul(k, vf_sub(yz,wx))); vf_store(m[8], vf_sub(s, vf_mul(k, vf_add(xx,yy))));
+    vf_store(m[9], tx); vf_store(m[10], ty); vf_store(m[11], tz);
+    for(int l=0;l<lanes;l++){
+        float* o=out[l].m;
+        o[0]=m[0][l]; o[1]=m[1][l]; o[2]=m[2][l]; o[3]=0;
+        o[4]=m[3][l]; o[5]=m[4][l]; o[6]=m[5][l]; o[7]=0;
+        o[8]=m[6][l]; o[9]=m[7][l]; o[10]=m[8][l]; o[11]=0;
+        o[12]=m[9][l]; o[13]=m[10][l]; o[14]=m[11][l]; o[15]=1;
+    }
+}
+
 // --------------------------- Palette ---------------------------
 typedef enum { COL_GREEN, COL_YELLOW, COL_RED, COL_BLUE, COL_CYAN, COL_PINK, COL_ORANGE, COL_PURPLE, COL_RANDOM, COL_COUNT } ColorKind;
 static const char* COLOR_NAMES[] = {"GREEN","YELLOW","RED","BLUE","CYAN","PINK","ORANGE","PURPLE","RANDOM"};
@@ -143,39 +734,44 @@ static vec3 neon_palette(ColorKind c){
 typedef enum { SH_CUBE, SH_SPHERE, SH_PYRAMID, SH_TORUS, SH_OCT, SH_COUNT } ShapeKind;
 static const char* SHAPE_NAMES[] = {"CUBE","SPHERE","PYRAMID","TORUS","OCTAHEDRON"};
 
-typedef struct { vec3* verts; unsigned* lines; int vcount; int lcount; } WireGeom; // lines = pairs of indices
+typedef struct { const vec3* verts; const unsigned* lines; int vcount; int lcount; } WireGeom; // lines = pairs of indices; may point at static tables
+
+// Fixed meshes are shared read-only tables; tessellated ones are allocated from `ar` and live
+// until the arena is freed.
+static WireGeom geom_static(const vec3* v, int vcount, const unsigned* e, int ecount){
+    WireGeom g={0}; g.vcount=vcount; g.verts=v; g.lcount=ecount/2; g.lines=e; return g;
+}
 
 static WireGeom make_cube(void){
-    static vec3 v[] = {
+    static const vec3 v[] = {
         {-0.5f,-0.5f,-0.5f},{0.5f,-0.5f,-0.5f},{0.5f,0.5f,-0.5f},{-0.5f,0.5f,-0.5f},
         {-0.5f,-0.5f, 0.5f},{0.5f,-0.5f, 0.5f},{0.5f,0.5f, 0.5f},{-0.5f,0.5f, 0.5f},
     };
-    static unsigned e[]={0,1,1,2,2,3,3,0, 4,5,5,6,6,7,7,4, 0,4,1,5,2,6,3,7};
-    WireGeom g={0};
-    g.vcount=ARRAY_LEN(v); g.verts=malloc(sizeof(v)); memcpy(g.verts,v,sizeof(v));
-    g.lcount=ARRAY_LEN(e)/2; g.lines=malloc(sizeof(e)); memcpy(g.lines,e,sizeof(e));
-    return g;
+    static const unsigned e[]={0,1,1,2,2,3,3,0, 4,5,5,6,6,7,7,4, 0,4,1,5,2,6,3,7};
+    return geom_static(v, ARRAY_LEN(v), e, ARRAY_LEN(e));
 }
 
 static WireGeom make_pyramid(void){
-    static vec3 v[]={ {-0.5f,0,-0.5f},{0.5f,0,-0.5f},{0.5f,0,0.5f},{-0.5f,0,0.5f},{0,0.8f,0} };
-    static unsigned e[]={0,1,1,2,2,3,3,0, 0,4,1,4,2,4,3,4};
-    WireGeom g={0}; g.vcount=ARRAY_LEN(v); g.verts=malloc(sizeof(v)); memcpy(g.verts,v,sizeof(v));
-    g.lcount=ARRAY_LEN(e)/2; g.lines=malloc(sizeof(e)); memcpy(g.lines,e,sizeof(e)); return g;
+    static const vec3 v[]={ {-0.5f,0,-0.5f},{0.5f,0,-0.5f},{0.5f,0,0.5f},{-0.5f,0,0.5f},{0,0.8f,0} };
+    static const unsigned e[]={0,1,1,2,2,3,3,0, 0,4,1,4,2,4,3,4};
+    return geom_static(v, ARRAY_LEN(v), e, ARRAY_LEN(e));
 }
 
 static WireGeom make_octahedron(void){
-    static vec3 v[]={ {0,1,0},{1,0,0},{0,0,1},{-1,0,0},{0,0,-1},{0,-1,0} };
-    static unsigned e[]={0,1,0,2,0,3,0,4, 1,2,2,3,3,4,4,1, 5,1,5,2,5,3,5,4};
-    WireGeom g={0}; g.vcount=ARRAY_LEN(v); g.verts=malloc(sizeof(v)); memcpy(g.verts,v,sizeof(v));
-    g.lcount=ARRAY_LEN(e)/2; g.lines=malloc(sizeof(e)); memcpy(g.lines,e,sizeof(e)); return g;
+    static const vec3 v[]={ {0,1,0},{1,0,0},{0,0,1},{-1,0,0},{0,0,-1},{0,-1,0} };
+    static const unsigned e[]={0,1,0,2,0,3,0,4, 1,2,2,3,3,4,4,1, 5,1,5,2,5,3,5,4};
+    return geom_static(v, ARRAY_LEN(v), e, ARRAY_LEN(e));
 }
 
-static WireGeom make_sphere(int lat, int lon){
+// Curved-shape generators; the baked build takes their output from ornament_meshes.h instead.
+#ifndef ORNAMENT_BAKED_MESHES
+static WireGeom make_sphere(Arena* ar, int lat, int lon){
     // Generate points on unit sphere; draw latitude circles and longitude circles
-    int maxv = (lat+1)*(lon+1) + (lat+lon)*64; // generous
-    vec3* v = (vec3*)malloc(sizeof(vec3)*maxv);
-    unsigned* e = (unsigned*)malloc(sizeof(unsigned)*maxv*4);
+    // exact sizes: lat-1 latitude rings of lon, lon meridians of 2*lat, 3 extra rings of 2*lon
+    int maxv = (lat-1)*lon + lon*lat*2 + 3*lon*2;
+    int maxe = ((lat-1)*lon + lon*(lat*2-1) + 3*lon*2)*2;
+    vec3* v = (vec3*)arena_alloc(ar, sizeof(vec3)*maxv, 16);
+    unsigned* e = (unsigned*)arena_alloc(ar, sizeof(unsigned)*maxe, 16);
     int vi=0, ei=0;
     // latitude rings (excluding poles)
     for(int i=1;i<lat;i++){
@@ -217,13 +813,13 @@ static WireGeom make_sphere(int lat, int lon){
         }
         e[ei++]=vi-1; e[ei++]=first;
     }
-    WireGeom g={0}; g.vcount=vi; g.verts=realloc(v,sizeof(vec3)*vi); g.lcount=ei/2; g.lines=realloc(e,sizeof(unsigned)*ei);
+    WireGeom g={0}; g.vcount=vi; g.verts=v; g.lcount=ei/2; g.lines=e;
     return g;
 }
 
-static WireGeom make_torus(int majorSeg, int minorSeg, float R, float r){
-    int vcap = majorSeg*minorSeg; vec3* v = (vec3*)malloc(sizeof(vec3)*vcap);
-    unsigned* e = (unsigned*)malloc(sizeof(unsigned)*vcap*4);
+static WireGeom make_torus(Arena* ar, int majorSeg, int minorSeg, float R, float r){
+    int vcap = majorSeg*minorSeg; vec3* v = (vec3*)arena_alloc(ar, sizeof(vec3)*vcap, 16);
+    unsigned* e = (unsigned*)arena_alloc(ar, sizeof(unsigned)*vcap*4, 16);
     int vi=0, ei=0;
     // store grid indices
     int idx[128][128]; // limits sufficient for modest segs
@@ -248,14 +844,50 @@ static WireGeom make_torus(int majorSeg, int minorSeg, float R, float r){
             e[ei++]=a; e[ei++]=c; // minor ring
         }
     }
-    WireGeom g={0}; g.vcount=vi; g.verts=realloc(v,sizeof(vec3)*vi); g.lcount=ei/2; g.lines=realloc(e,sizeof(unsigned)*ei);
     // normalize size
-    float maxr=0; for(int i=0;i<g.vcount;i++){ float rlen=v3_len(g.verts[i]); if(rlen>maxr) maxr=rlen; }
-    float s=0.5f/maxr; for(int i=0;i<g.vcount;i++){ g.verts[i]=v3_scale(g.verts[i],s); }
+    float maxr=0; for(int i=0;i<vi;i++){ float rlen=v3_len(v[i]); if(rlen>maxr) maxr=rlen; }
+    float s=0.5f/maxr; for(int i=0;i<vi;i++){ v[i]=v3_scale(v[i],s); }
+    WireGeom g={0}; g.vcount=vi; g.verts=v; g.lcount=ei/2; g.lines=e; // exact: vcap verts, 2 edges each
     return g;
 }
+#endif
 
-static void free_geom(WireGeom* g){ if(!g) return; free(g->verts); free(g->lines); g->verts=NULL; g->lines=NULL; g->vcount=g->lcount=0; }
+// Tessellation levels for the curved shapes; gen_meshes.c bakes exactly these.
+#define MESH_LODS 3
+#define MESH_LOD_DEFAULT 1
+#ifndef ORNAMENT_BAKED_MESHES
+static const int SPHERE_LOD[MESH_LODS][2] = { {6,10}, {10,16}, {16,24} }; // lat, lon
+static const int TORUS_LOD[MESH_LODS][2]  = { {16,6}, {32,12}, {48,18} }; // major, minor segments
+#endif
+#define TORUS_R 1.0f
+#define TORUS_r 0.35f
+
+// Built with -DORNAMENT_BAKED_MESHES (./compile.sh does), the sphere and torus tables are
+// generated at build time into ornament_meshes.h: static const BAKED_SPHERE[MESH_LODS] and
+// BAKED_TORUS[MESH_LODS], so startup computes no geometry and meshes live in read-only pages.
+#ifdef ORNAMENT_BAKED_MESHES
+#include "ornament_meshes.h"
+#endif
+
+static WireGeom make_shape_geom(Arena* ar, int shape, int lod){
+#ifdef ORNAMENT_BAKED_MESHES
+    (void)ar; // every mesh is static
+#endif
+    lod=CLAMP(lod,0,MESH_LODS-1);
+    switch(shape){
+        case SH_CUBE: return make_cube();
+        case SH_PYRAMID: return make_pyramid();
+        case SH_OCT: return make_octahedron();
+#ifdef ORNAMENT_BAKED_MESHES
+        case SH_SPHERE: return BAKED_SPHERE[lod];
+        case SH_TORUS: return BAKED_TORUS[lod];
+#else
+        case SH_SPHERE: return make_sphere(ar, SPHERE_LOD[lod][0], SPHERE_LOD[lod][1]);
+        case SH_TORUS: return make_torus(ar, TORUS_LOD[lod][0], TORUS_LOD[lod][1], TORUS_R, TORUS_r);
+#endif
+        default: return make_cube();
+    }
+}
 
 // --------------------------- GL helpers (immediate-style line draw) ---------------------------
 static void draw_wire(const WireGeom* g){
@@ -284,82 +916,238 @@ static void mult_matrix(const mat4* m){ glMultMatrixf(m->m); }
 typedef enum { POS_TL, POS_TC, POS_TR, POS_CL, POS_C, POS_CR, POS_BL, POS_BC, POS_BR, POS_COUNT } Anchor;
 static const char* POS_NAMES[] = {"TOP-LEFT","TOP-CENTER","TOP-RIGHT","CENTER-LEFT","CENTER","CENTER-RIGHT","BOTTOM-LEFT","BOTTOM-CENTER","BOTTOM-RIGHT"};
 
+// Optional per-shape knobs (KEY=VALUE after the three positional fields) let cheap ornaments on
+// peripheral screens cost less than the centrepiece.
+#define GLOW_MAX_PASSES 4
 typedef struct {
     ShapeKind shape;
     ColorKind color;
     Anchor pos;
     int screen;
+    int lod;     // LOD=0..MESH_LODS-1: tessellation of SPHERE/TORUS
+    int glow;    // GLOW=1..4: line passes (3 = classic look)
+    float width; // WIDTH=: line width multiplier
+    float spin;  // SPIN=: spin rate multiplier
+    float scale; // SCALE=: size multiplier
 } ShapeConfig;
 
+static ShapeConfig shape_config(ShapeKind sh, ColorKind co, Anchor po, int screen){
+    ShapeConfig c={ sh, co, po, screen, MESH_LOD_DEFAULT, 3, 1.0f, 1.0f, 1.0f }; return c;
+}
+
+// Per-shape render data (cold). Animation state lives in ShapeAnim at the same index.
 typedef struct {
     ShapeKind shape;
     ColorKind color;
-    float hue; // for RANDOM cycling
-    float hueSpeed; // Hz around [0.25..0.5]
-    quat orient; // current orientation
-    quat target; // target reorientation
-    float spinY, spinX; // deg/s
-    float reorientTimer; // seconds until new target
-    float reorientDur; // duration of slerp
-    float reorientT; // 0..1 progress
     vec3 worldPos; // placement in NDC-ish units mapped to camera
     WireGeom geom;
+    int lod, glow; float width, scale; // from ShapeConfig
+    int window;    // index into ScreenSet.arr; shapes of one window are contiguous
 } ShapeRuntime;
 
+// One keyframe segment of the analytic model, slerp constants precomputed: qa/qb with the
+// sign already fixed, th=acos(dot), dot, invSin=1/sin(th) (0 selects the lerp path).
+typedef struct { long long k; quat qa, qb; float th, dot, invSin; } KeySeg;
+
+// Hot animation state as structure-of-arrays: one stream per field so update_shapes can run
+// SIMD_WIDTH shapes per iteration. Streams are SIMD_ALIGN-aligned and padded to a multiple of
+// SIMD_WIDTH with inert lanes, so batches never need a scalar tail.
+typedef struct {
+    int count, cap;
+    float *hue;                 // RANDOM colour: hue at t=0; both models use hue + hueSpeed*t
+    float *hueSpeed;            // Hz around [0.25..0.5]
+    float *ox, *oy, *oz, *ow;   // current orientation
+    float *px, *py, *pz, *pw;   // orientation one sim step earlier (render interpolates px..ox)
+    float *tx, *ty, *tz, *tw;   // target reorientation
+    float *spinY, *spinX;       // deg/s
+    float *timer;               // seconds until new target
+    float *dur;                 // duration of slerp
+    float *t;                   // 0..1 progress
+    float *period;              // analytic model: seconds per keyframe segment (hold + slerp)
+    Rng* rng;                   // per-shape stream derived from --seed
+    KeySeg* seg;                // analytic model: slerp constants of the segment last evaluated
+    uint32_t* id;               // keyframe stream of the shape; stays with it when a reload moves it
+    uint64_t seed;              // --seed; keyframe k of shape i is derived from (seed, k, i)
+    void* block;                // single allocation backing every stream (NULL when arena-backed)
+} ShapeAnim;
+
 typedef struct { int count; ShapeConfig* items; } ShapeList;
 
+typedef struct OverdrawTarget OverdrawTarget;
+typedef struct TelemetrySlot TelemetrySlot;
 typedef struct {
     GLFWwindow* win;
     GLFWmonitor* monitor;
     int monIndex;
     int width, height;
     vec2 contentScale; // DPI scaling
+    int refreshHz;     // monitor refresh rate (0 = unknown / offscreen)
     Camera cam;
-    int startIndex; // index into runtime array
-    int count;      // how many shapes on this window
+    int startIndex; // first shape of this window in the runtime array
+    int count;      // how many shapes on this window (runtime[startIndex..+count))
+    GLuint fbo, colorRb, depthRb; // headless offscreen target (win==NULL)
+    OverdrawTarget* od; // --debug-overdraw counting target, made on first use
+    TelemetrySlot* tm;  // --telemetry/--metrics-file frame history and timer queries, made on first use
 } ScreenWindow;
+static void telemetry_window_release(ScreenWindow* sw); // frees sw->tm; its context must be current
+
+// --- File mapping: read-only view of a whole file (mmap / MapViewOfFile) ---
+typedef struct { const char* data; size_t size; void* base; } MappedFile;
+
+static int map_file(const char* path, MappedFile* m){
+    memset(m,0,sizeof(*m)); m->data="";
+#ifdef _WIN32
+    HANDLE f=CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(f==INVALID_HANDLE_VALUE) return 0;
+    LARGE_INTEGER sz; if(!GetFileSizeEx(f,&sz)){ CloseHandle(f); return 0; }
+    if(sz.QuadPart>0){
+        HANDLE h=CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(h){ m->base=MapViewOfFile(h, FILE_MAP_READ, 0, 0, 0); CloseHandle(h); }
+        if(!m->base){ CloseHandle(f); return 0; }
+        m->data=(const char*)m->base; m->size=(size_t)sz.QuadPart;
+    }
+    CloseHandle(f);
+#else
+    int fd=open(path, O_RDONLY); if(fd<0) return 0;
+    struct stat st; if(fstat(fd,&st)!=0){ close(fd); return 0; }
+    if(st.st_size>0){
+        void* p=mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(p==MAP_FAILED){ close(fd); return 0; }
+        m->base=p; m->data=(const char*)p; m->size=(size_t)st.st_size;
+    }
+    close(fd);
+#endif
+    return 1;
+}
+
+static void unmap_file(MappedFile* m){
+#ifdef _WIN32
+    if(m->base) UnmapViewOfFile(m->base);
+#else
+    if(m->base) munmap(m->base, m->size);
+#endif
+    memset(m,0,sizeof(*m));
+}
+
+// --- INI tokenizer: works on [p,e) spans of the mapped file, never copies or writes ---
+typedef struct { const char* p; const char* e; } Span;
+
+static int is_blank(char c){ return c==' '||c=='\t'||c=='\r'; }
+static Span span_trim(Span s){ while(s.p<s.e && is_blank(*s.p)) s.p++; while(s.e>s.p && is_blank(s.e[-1])) s.e--; return s; }
+static Span span_unquote(Span s){ if(s.e-s.p>=2 && *s.p=='"' && s.e[-1]=='"'){ s.p++; s.e--; } return s; }
+static int span_ieq(Span s, const char* name){
+    for(; s.p<s.e; s.p++, name++){ char a=*s.p, b=*name; if(a>='a'&&a<='z') a-='a'-'A'; if(b>='a'&&b<='z') b-='a'-'A'; if(a!=b) return 0; }
+    return *name=='\0';
+}
+static int span_lookup(Span s, const char* const* names, int n){ for(int i=0;i<n;i++) if(span_ieq(s,names[i])) return i; return -1; }
+static int span_int(Span s, int* out){
+    const char* p=s.p; int neg=0; long v=0;
+    if(p<s.e && (*p=='-'||*p=='+')){ neg=*p=='-'; p++; }
+    if(p==s.e) return 0;
+    for(; p<s.e; p++){ if(*p<'0'||*p>'9') return 0; v=v*10+(*p-'0'); if(v>1000000) return 0; }
+    *out=(int)(neg? -v : v); return 1;
+}
+
+// Diagnostics are "path:line:col: warn: ...", capped so a broken generated file stays readable.
+#define INI_MAX_DIAGS 20
+typedef struct { const char* path; int line; const char* lineStart; int diags; } IniCtx;
+static void ini_warn(IniCtx* c, const char* at, const char* msg, Span tok){
+    if(++c->diags > INI_MAX_DIAGS) return;
+    fprintf(stderr,"%s:%d:%d: warn: %s", c->path, c->line, (int)(at - c->lineStart)+1, msg);
+    if(tok.e>tok.p) fprintf(stderr," '%.*s'", (int)(tok.e-tok.p), tok.p);
+    fputc('\n', stderr);
+}
+
+// Decimal number; the span is copied out because strtod needs a terminator.
+static int span_float(Span s, float* out){
+    char buf[32]; size_t n=(size_t)(s.e-s.p); if(n==0 || n>=sizeof(buf)) return 0;
+    memcpy(buf,s.p,n); buf[n]=0; char* end; double v=strtod(buf,&end);
+    if(*end || !isfinite(v)) return 0;
+    *out=(float)v; return 1;
+}
 
-// trim helper
-static char* trim(char* s){ while(*s==' '||*s=='\t'||*s=='\r') s++; size_t n=strlen(s); while(n>0 && (s[n-1]==' '||s[n-1]=='\t'||s[n-1]=='\r'||s[n-1]=='\n')){ s[--n]='\0'; } return s; }
-static int ieq(const char* a,const char* b){ for(;;a++,b++){ char ca=*a, cb=*b; if(ca>='a'&&ca<='z') ca-='a'-'A'; if(cb>='a'&&cb<='z') cb-='a'-'A'; if(ca!=cb) return 0; if(ca=='\0') return 1; } }
+// KEY=VALUE after the positional fields; bad or out-of-range values warn and keep/clamp.
+#define INI_MAX_KNOBS 5
+static const char* KNOB_NAMES[] = {"LOD","GLOW","WIDTH","SPIN","SCALE"};
+static void parse_knob(IniCtx* c, Span f, ShapeConfig* out){
+    const char* eq=memchr(f.p, '=', (size_t)(f.e-f.p));
+    if(!eq){ ini_warn(c, f.p, "expected KEY=VALUE", f); return; }
+    Span k=span_trim((Span){ f.p, eq }), v=span_trim((Span){ eq+1, f.e });
+    int knob=span_lookup(k, KNOB_NAMES, ARRAY_LEN(KNOB_NAMES));
+    if(knob<0){ ini_warn(c, k.p, "unknown key (LOD, GLOW, WIDTH, SPIN, SCALE)", k); return; }
+    float x; int iv;
+    if(knob<2){ // LOD and GLOW are counts
+        if(!span_int(v, &iv)){ ini_warn(c, v.p, "expected an integer", v); return; }
+        x=(float)iv;
+    } else if(!span_float(v, &x)){ ini_warn(c, v.p, "expected a number", v); return; }
+    static const float lo[]={ 0, 1, 0.1f, 0.05f, 0.1f }, hi[]={ MESH_LODS-1, GLOW_MAX_PASSES, 10, 10, 4 };
+    if(x<lo[knob] || x>hi[knob]){ ini_warn(c, v.p, "value out of range, clamped", v); x=CLAMP(x,lo[knob],hi[knob]); }
+    switch(knob){
+        case 0: out->lod=(int)x; break;
+        case 1: out->glow=(int)x; break;
+        case 2: out->width=x; break;
+        case 3: out->spin=x; break;
+        default: out->scale=x; break;
+    }
+}
 
-static int parse_color(const char* s){ for(int i=0;i<COL_COUNT;i++) if(ieq(s,COLOR_NAMES[i])) return i; return -1; }
-static int parse_shape(const char* s){ for(int i=0;i<SH_COUNT;i++) if(ieq(s,SHAPE_NAMES[i])) return i; return -1; }
-static int parse_pos(const char* s){ for(int i=0;i<POS_COUNT;i++) if(ieq(s,POS_NAMES[i])) return i; return -1; }
+// One line, already stripped of its newline. Expects: SHAPE=[COLOR, POSITION, SCREEN(, KEY=VALUE)*]
+static int parse_ini_line(IniCtx* c, Span ln, ShapeConfig* out){
+    const Span none={0};
+    ln=span_trim(ln); if(ln.p==ln.e || *ln.p=='#') return 0;
+    const char* eq=memchr(ln.p, '=', (size_t)(ln.e-ln.p));
+    if(!eq){ ini_warn(c, ln.p, "expected SHAPE=[COLOR, POSITION, SCREEN]", none); return 0; }
+    Span lhs=span_trim((Span){ ln.p, eq });
+    int sh=span_lookup(lhs, SHAPE_NAMES, SH_COUNT);
+    if(sh<0){ ini_warn(c, lhs.p, "unknown shape", lhs); return 0; }
+    Span rhs=span_trim((Span){ eq+1, ln.e });
+    if(rhs.p==rhs.e || *rhs.p!='['){ ini_warn(c, rhs.p, "expected '[' after '='", none); return 0; }
+    const char* rb=memchr(rhs.p, ']', (size_t)(rhs.e-rhs.p));
+    if(!rb){ ini_warn(c, rhs.e, "missing ']'", none); return 0; }
+    Span f[3+INI_MAX_KNOBS]; int nf=0; const char* q=rhs.p+1;
+    for(;;){
+        const char* comma=memchr(q, ',', (size_t)(rb-q)); const char* fe=comma? comma : rb;
+        if(nf<3+INI_MAX_KNOBS) f[nf]=span_unquote(span_trim((Span){ q, fe }));
+        nf++;
+        if(!comma) break;
+        q=comma+1;
+    }
+    if(nf<3){ ini_warn(c, rb, "expected 3 fields [COLOR, POSITION, SCREEN]", none); return 0; }
+    if(nf>3+INI_MAX_KNOBS) ini_warn(c, rb, "extra fields ignored", none);
+    int co=span_lookup(f[0], COLOR_NAMES, COL_COUNT);
+    if(co<0){ ini_warn(c, f[0].p, "unknown color", f[0]); return 0; }
+    int po=span_lookup(f[1], POS_NAMES, POS_COUNT);
+    if(po<0){ ini_warn(c, f[1].p, "unknown position", f[1]); return 0; }
+    int sc=0;
+    if(!span_int(f[2], &sc)){ ini_warn(c, f[2].p, "screen must be an integer", f[2]); return 0; }
+    *out=shape_config((ShapeKind)sh, (ColorKind)co, (Anchor)po, sc);
+    for(int i=3;i<nf && i<3+INI_MAX_KNOBS;i++) parse_knob(c, f[i], out);
+    return 1;
+}
 
-static ShapeList load_ini(const char* path){
+// Maps the file and parses it in one pass. The line count is taken first (memchr), so the
+// item array is sized once, from `ar`.
+static ShapeList load_ini(const char* path, Arena* ar){
     ShapeList L={0};
-    FILE* f=fopen(path,"rb");
-    if(!f){ fprintf(stderr,"[ornament] no ini at %s, using default\n", path); L.count=1; L.items=calloc(1,sizeof(ShapeConfig)); L.items[0]=(ShapeConfig){SH_CUBE,COL_GREEN,POS_C,0}; return L; }
-    char line[512];
-    while(fgets(line,sizeof(line),f)){
-        char* p=trim(line); if(*p=='\0'||*p=='#') continue;
-        // Expect: SHAPE=[COLOR, POSITION, SCREEN]
-        char lhs[64]={0}, color[64]={0}, pos[64]={0}; int screen=-1;
-        char* eq=strchr(p,'='); if(!eq){ fprintf(stderr,"warn: bad line: %s\n", p); continue; }
-        size_t ln = (size_t)(eq - p);
-        if(ln>=sizeof(lhs)) ln=sizeof(lhs)-1; memcpy(lhs,p,ln); lhs[ln]='\0';
-        char* lb=strchr(eq,'['); char* rb=strchr(eq,']'); if(!lb||!rb||rb<lb){ fprintf(stderr,"warn: missing []: %s\n", p); continue; }
-        char inside[256]={0}; size_t inl=(size_t)(rb-lb-1); if(inl>=sizeof(inside)) inl=sizeof(inside)-1; memcpy(inside,lb+1,inl); inside[inl]='\0';
-        // split by commas
-        char* a=strtok(inside,","); char* b=strtok(NULL,","); char* c=strtok(NULL,","); if(!a||!b||!c){ fprintf(stderr,"warn: need 3 fields: %s\n", p); continue; }
-        a=trim(a); b=trim(b); c=trim(c);
-        // remove optional quotes
-        if(*a=='"'&&a[strlen(a)-1]=='"'){ a[strlen(a)-1]='\0'; a++; }
-        if(*b=='"'&&b[strlen(b)-1]=='"'){ b[strlen(b)-1]='\0'; b++; }
-        if(*c=='"'&&c[strlen(c)-1]=='"'){ c[strlen(c)-1]='\0'; c++; }
-        int sh=parse_shape(lhs); int co=parse_color(a); int po=parse_pos(b); int sc=atoi(c);
-        if(sh<0||co<0||po<0){ fprintf(stderr,"warn: invalid token(s): %s\n", p); continue; }
-        L.items = (ShapeConfig*)realloc(L.items, sizeof(ShapeConfig)*(L.count+1));
-        L.items[L.count++] = (ShapeConfig){ (ShapeKind)sh, (ColorKind)co, (Anchor)po, sc };
+    MappedFile mf;
+    if(!map_file(path, &mf)){ fprintf(stderr,"[ornament] no ini at %s, using default\n", path); L.count=1; L.items=arena_alloc(ar,sizeof(ShapeConfig),8); L.items[0]=shape_config(SH_CUBE,COL_GREEN,POS_C,0); return L; }
+    const char *p=mf.data, *end=mf.data+mf.size;
+    size_t lines=1;
+    for(const char* q=p; (q=memchr(q, '\n', (size_t)(end-q)))!=NULL; q++) lines++;
+    L.items=(ShapeConfig*)arena_alloc(ar, sizeof(ShapeConfig)*lines, 8);
+    IniCtx c={ path, 0, p, 0 };
+    while(p<end && L.items){
+        const char* eol=memchr(p, '\n', (size_t)(end-p)); if(!eol) eol=end;
+        c.line++; c.lineStart=p;
+        if(parse_ini_line(&c, (Span){ p, eol }, &L.items[L.count])) L.count++;
+        p=eol+1;
     }
-    fclose(f);
-    if(L.count==0){ L.count=1; L.items=calloc(1,sizeof(ShapeConfig)); L.items[0]=(ShapeConfig){SH_CUBE,COL_GREEN,POS_C,0}; }
+    if(c.diags>INI_MAX_DIAGS) fprintf(stderr,"%s: %d more warnings suppressed\n", path, c.diags-INI_MAX_DIAGS);
+    unmap_file(&mf);
+    if(L.count==0){ L.count=1; L.items=arena_alloc(ar,sizeof(ShapeConfig),8); L.items[0]=shape_config(SH_CUBE,COL_GREEN,POS_C,0); }
     return L;
 }
 
-static void free_list(ShapeList* L){ free(L->items); L->items=NULL; L->count=0; }
-
 // --------------------------- Placement helpers ---------------------------
 static vec3 anchor_to_ndc(Anchor a){ // returns x,y in [-1,1] approximate anchor
     switch(a){
@@ -390,107 +1178,1976 @@ static const unsigned char ICON_PNG[] = {
 
 // --------------------------- Runtime & Windows ---------------------------
 
-typedef struct { ScreenWindow* arr; int count; } ScreenSet;
+typedef struct {
+    ScreenWindow* arr; int count;
+    int monCount; // screens placement is resolved for
+} ScreenSet; // arr is heap-owned: a monitor hotplug swaps in a new one sized to the monitor count
+
+// Window showing SCREEN index `screen`, clamped to the monitors present like placement is;
+// the first window when that monitor has none (e.g. its window failed to open).
+static int screen_window(const ScreenSet* scr, int screen){
+    int mon=screen<0? 0 : screen>=scr->monCount? scr->monCount-1 : screen;
+    for(int w=0;w<scr->count;w++) if(scr->arr[w].monIndex==mon) return w;
+    return 0;
+}
+
+// Stable counting sort of the config into window order, so each window draws one contiguous
+// run of shapes. File order is kept within a screen, which is all placement depends on.
+// Returns order[j] = file index of sorted item j (from `ar`), or NULL when out of memory.
+static int* sort_by_window(ShapeList* L, const ScreenSet* scr, Arena* ar){
+    int* order=(int*)arena_alloc(ar, sizeof(int)*(size_t)(L->count+1), 8);
+    int* win=(int*)arena_alloc(ar, sizeof(int)*(size_t)(L->count+1), 8);
+    int* start=(int*)arena_calloc(ar, (size_t)scr->count+1, sizeof(int), 8);
+    ShapeConfig* sorted=(ShapeConfig*)arena_alloc(ar, sizeof(ShapeConfig)*(size_t)(L->count+1), 8);
+    if(!order || !win || !start || !sorted) return NULL;
+    for(int i=0;i<L->count;i++){ win[i]=screen_window(scr, L->items[i].screen); start[win[i]+1]++; }
+    for(int w=0;w<scr->count;w++) start[w+1]+=start[w];
+    for(int i=0;i<L->count;i++){ int j=start[win[i]]++; sorted[j]=L->items[i]; order[j]=i; }
+    L->items=sorted;
+    return order;
+}
+
+// Windows' [startIndex, startIndex+count) ranges from runtime[].window (already sorted).
+static void bind_windows(ScreenSet* scr, const ShapeRuntime* rt, int n){
+    for(int w=0;w<scr->count;w++){ scr->arr[w].startIndex=0; scr->arr[w].count=0; }
+    for(int i=n-1;i>=0;i--){ ScreenWindow* sw=&scr->arr[rt[i].window]; sw->startIndex=i; sw->count++; }
+}
+
+typedef struct {
+    const char* iniPath;
+    float brightness, thickness;
+    int fpsCap, vsync;
+    int headless, headlessW, headlessH;
+    int maxFrames; // 0 = run until every window is closed (headless: HEADLESS_DEFAULT_FRAMES)
+    const char* statsPath; // --stats-json: per-run summary written at exit
+    uint64_t seed; // --seed; defaults to the current time
+    int headlessSizeSet; // --headless-size given (otherwise a replay uses the recorded sizes)
+    const char* recordPath; const char* replayPath;
+    int replayRealtime; // --replay-realtime: pace replayed frames by their recorded dt
+    int threads; // --threads: job pool size including the main thread; 0 = one per CPU
+    int simHz;   // --sim-hz: fixed simulation rate; rendering interpolates between steps
+    int analytic; // --anim analytic: closed-form orientation, no simulation steps
+    double startTime; // --start-time: initial animation time in seconds (analytic model)
+    const char* compilePath; const char* outPath; // --compile-config in.ini -o out.orn
+    const char* scenePath; // --scene: start from a compiled scene instead of the INI (the INI if it is rejected)
+    int noSceneMeshes;     // --no-meshes: compile without the mesh section
+    int watch;             // --watch / --no-watch: hot-reload the INI; -1 = windowed runs only
+    int debugOverdraw;     // --debug-overdraw: show fragments per pixel as a heat map
+    const char* controlPath; // --control PATH / --no-control: command socket; NULL = none
+    const char* telemetryName; // --telemetry NAME: shared-memory telemetry block
+    const char* metricsPath; double metricsInterval; // --metrics-file PATH, --metrics-interval SEC
+} Options;
+static int g_layoutStacked; // --layout stacked (see Layout)
+
+// --------------------------- Headless (offscreen) backend ---------------------------
+// --headless renders every configured screen into its own FBO on one surfaceless GL context,
+// so frame cost can be measured on machines without a display or GPU (Mesa llvmpipe).
+// EGL_MESA_platform_surfaceless is tried first, then OSMesa. Both are dlopen'ed, so the
+// normal build links nothing extra.
+#define HEADLESS_MAX_SCREENS 16
+#define HEADLESS_DEFAULT_FRAMES 600 // offscreen targets never close: --headless without --frames stops here
+
+// Framebuffer-object entry points (GL 3.0 / ARB_framebuffer_object), fetched at runtime.
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_RENDERBUFFER 0x8D41
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_DEPTH_ATTACHMENT 0x8D00
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+#ifndef GL_DEPTH_COMPONENT24
+#define GL_DEPTH_COMPONENT24 0x81A6
+#endif
+#ifndef GL_R32F
+#define GL_R16F 0x822D
+#define GL_R32F 0x822E
+#endif
+
+typedef void (*HlProc)(void);
+typedef void (*HlGenFn)(GLsizei, GLuint*);
+typedef void (*HlDeleteFn)(GLsizei, const GLuint*);
+typedef void (*HlBindFn)(GLenum, GLuint);
+typedef void (*HlStorageFn)(GLenum, GLenum, GLsizei, GLsizei);
+typedef void (*HlAttachFn)(GLenum, GLenum, GLenum, GLuint);
+typedef GLenum (*HlStatusFn)(GLenum);
+
+#ifdef ORNAMENT_HAS_HEADLESS
+// EGL / OSMesa entry points, declared locally so no EGL or OSMesa headers are needed
+typedef void* (*EglGetPlatformDisplayFn)(unsigned platform, void* native, const int32_t* attribs);
+typedef unsigned (*EglInitializeFn)(void* dpy, int32_t* major, int32_t* minor);
+typedef unsigned (*EglBindApiFn)(unsigned api);
+typedef void* (*EglCreateContextFn)(void* dpy, void* config, void* share, const int32_t* attribs);
+typedef unsigned (*EglMakeCurrentFn)(void* dpy, void* draw, void* read, void* ctx);
+typedef unsigned (*EglDestroyContextFn)(void* dpy, void* ctx);
+typedef unsigned (*EglTerminateFn)(void* dpy);
+typedef HlProc (*GetProcFn)(const char* name);
+typedef void* (*OsmCreateContextFn)(GLenum format, GLint depth, GLint stencil, GLint accum, void* share);
+typedef GLboolean (*OsmMakeCurrentFn)(void* ctx, void* buf, GLenum type, GLsizei w, GLsizei h);
+typedef void (*OsmDestroyContextFn)(void* ctx);
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#define EGL_OPENGL_API 0x30A2
+
+static struct {
+    void* lib; const char* api;
+    void* eglDpy; void* ctx;
+    unsigned char osmBuf[16*16*4]; // OSMesa needs a bound buffer; rendering goes to FBOs
+    GetProcFn getProc;
+    HlGenFn genFramebuffers, genRenderbuffers;
+    HlDeleteFn deleteFramebuffers, deleteRenderbuffers;
+    HlBindFn bindFramebuffer, bindRenderbuffer;
+    HlStorageFn renderbufferStorage; HlAttachFn framebufferRenderbuffer; HlStatusFn checkFramebufferStatus;
+} g_hl;
+
+static int headless_init_egl(void){
+    void* lib=dlopen("libEGL.so.1", RTLD_NOW|RTLD_LOCAL); if(!lib) return 0;
+    GetProcFn getProc=(GetProcFn)dlsym(lib,"eglGetProcAddress");
+    EglGetPlatformDisplayFn getDisplay = getProc? (EglGetPlatformDisplayFn)getProc("eglGetPlatformDisplayEXT") : NULL;
+    EglInitializeFn initialize=(EglInitializeFn)dlsym(lib,"eglInitialize");
+    EglBindApiFn bindApi=(EglBindApiFn)dlsym(lib,"eglBindAPI");
+    EglCreateContextFn createContext=(EglCreateContextFn)dlsym(lib,"eglCreateContext");
+    EglMakeCurrentFn makeCurrent=(EglMakeCurrentFn)dlsym(lib,"eglMakeCurrent");
+    EglDestroyContextFn destroyContext=(EglDestroyContextFn)dlsym(lib,"eglDestroyContext");
+    EglTerminateFn terminate=(EglTerminateFn)dlsym(lib,"eglTerminate");
+    if(!getDisplay||!initialize||!bindApi||!createContext||!makeCurrent||!destroyContext||!terminate){ dlclose(lib); return 0; }
+    int32_t major=0, minor=0;
+    void* dpy=getDisplay(EGL_PLATFORM_SURFACELESS_MESA, NULL, NULL);
+    if(!dpy || !initialize(dpy,&major,&minor)){ dlclose(lib); return 0; }
+    // EGL_KHR_no_config_context + EGL_KHR_surfaceless_context: no config, no surface
+    void* ctx=bindApi(EGL_OPENGL_API)? createContext(dpy, NULL, NULL, NULL) : NULL;
+    if(!ctx || !makeCurrent(dpy, NULL, NULL, ctx)){ if(ctx) destroyContext(dpy, ctx); terminate(dpy); dlclose(lib); return 0; }
+    g_hl.lib=lib; g_hl.eglDpy=dpy; g_hl.ctx=ctx; g_hl.getProc=getProc; g_hl.api="EGL surfaceless";
+    return 1;
+}
+
+static int headless_init_osmesa(void){
+    void* lib=dlopen("libOSMesa.so.8", RTLD_NOW|RTLD_LOCAL); if(!lib) lib=dlopen("libOSMesa.so", RTLD_NOW|RTLD_LOCAL); if(!lib) return 0;
+    OsmCreateContextFn createContext=(OsmCreateContextFn)dlsym(lib,"OSMesaCreateContextExt");
+    OsmMakeCurrentFn makeCurrent=(OsmMakeCurrentFn)dlsym(lib,"OSMesaMakeCurrent");
+    GetProcFn getProc=(GetProcFn)dlsym(lib,"OSMesaGetProcAddress");
+    if(!createContext||!makeCurrent||!getProc){ dlclose(lib); return 0; }
+    void* ctx=createContext(GL_RGBA, 24, 0, 0, NULL);
+    if(!ctx || !makeCurrent(ctx, g_hl.osmBuf, GL_UNSIGNED_BYTE, 16, 16)){ dlclose(lib); return 0; }
+    g_hl.lib=lib; g_hl.ctx=ctx; g_hl.getProc=getProc; g_hl.api="OSMesa";
+    return 1;
+}
+
+// Returns the backend name, or NULL if no offscreen context could be created.
+static const char* headless_init(void){
+    if(!headless_init_egl() && !headless_init_osmesa()) return NULL;
+    g_hl.genFramebuffers=(HlGenFn)g_hl.getProc("glGenFramebuffers");
+    g_hl.genRenderbuffers=(HlGenFn)g_hl.getProc("glGenRenderbuffers");
+    g_hl.deleteFramebuffers=(HlDeleteFn)g_hl.getProc("glDeleteFramebuffers");
+    g_hl.deleteRenderbuffers=(HlDeleteFn)g_hl.getProc("glDeleteRenderbuffers");
+    g_hl.bindFramebuffer=(HlBindFn)g_hl.getProc("glBindFramebuffer");
+    g_hl.bindRenderbuffer=(HlBindFn)g_hl.getProc("glBindRenderbuffer");
+    g_hl.renderbufferStorage=(HlStorageFn)g_hl.getProc("glRenderbufferStorage");
+    g_hl.framebufferRenderbuffer=(HlAttachFn)g_hl.getProc("glFramebufferRenderbuffer");
+    g_hl.checkFramebufferStatus=(HlStatusFn)g_hl.getProc("glCheckFramebufferStatus");
+    if(!g_hl.genFramebuffers||!g_hl.bindFramebuffer||!g_hl.framebufferRenderbuffer||!g_hl.checkFramebufferStatus){ fprintf(stderr,"[ornament] %s context lacks framebuffer objects\n", g_hl.api); return NULL; }
+    fprintf(stderr,"[ornament] headless: %s, %s\n", g_hl.api, (const char*)glGetString(GL_RENDERER));
+    return g_hl.api;
+}
+
+static int headless_create_target(ScreenWindow* sw, int w, int h){
+    g_hl.genFramebuffers(1,&sw->fbo); g_hl.genRenderbuffers(1,&sw->colorRb); g_hl.genRenderbuffers(1,&sw->depthRb);
+    g_hl.bindRenderbuffer(GL_RENDERBUFFER, sw->colorRb); g_hl.renderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, h);
+    g_hl.bindRenderbuffer(GL_RENDERBUFFER, sw->depthRb); g_hl.renderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, w, h);
+    g_hl.bindFramebuffer(GL_FRAMEBUFFER, sw->fbo);
+    g_hl.framebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, sw->colorRb);
+    g_hl.framebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, sw->depthRb);
+    if(g_hl.checkFramebufferStatus(GL_FRAMEBUFFER)!=GL_FRAMEBUFFER_COMPLETE) return 0;
+    sw->width=w; sw->height=h; sw->contentScale.x=sw->contentScale.y=1.0f;
+    return 1;
+}
+
+static void headless_bind_target(const ScreenWindow* sw){ g_hl.bindFramebuffer(GL_FRAMEBUFFER, sw->fbo); }
+
+static void headless_destroy_target(ScreenWindow* sw){
+    g_hl.deleteFramebuffers(1,&sw->fbo); g_hl.deleteRenderbuffers(1,&sw->colorRb); g_hl.deleteRenderbuffers(1,&sw->depthRb);
+    sw->fbo=sw->colorRb=sw->depthRb=0;
+}
+
+static void headless_shutdown(void){
+    if(!g_hl.lib) return;
+    if(g_hl.eglDpy){
+        EglMakeCurrentFn makeCurrent=(EglMakeCurrentFn)dlsym(g_hl.lib,"eglMakeCurrent");
+        EglDestroyContextFn destroyContext=(EglDestroyContextFn)dlsym(g_hl.lib,"eglDestroyContext");
+        EglTerminateFn terminate=(EglTerminateFn)dlsym(g_hl.lib,"eglTerminate");
+        makeCurrent(g_hl.eglDpy, NULL, NULL, NULL); destroyContext(g_hl.eglDpy, g_hl.ctx); terminate(g_hl.eglDpy);
+    } else {
+        OsmDestroyContextFn destroyContext=(OsmDestroyContextFn)dlsym(g_hl.lib,"OSMesaDestroyContext");
+        if(destroyContext) destroyContext(g_hl.ctx);
+    }
+    dlclose(g_hl.lib); memset(&g_hl, 0, sizeof(g_hl));
+}
+#else
+static const char* headless_init(void){ return NULL; }
+static int headless_create_target(ScreenWindow* sw, int w, int h){ (void)sw; (void)w; (void)h; return 0; }
+static void headless_bind_target(const ScreenWindow* sw){ (void)sw; }
+static void headless_destroy_target(ScreenWindow* sw){ (void)sw; }
+static void headless_shutdown(void){}
+#endif
+
+// --------------------------- Overdraw debug view ---------------------------
+// --debug-overdraw: every glow pass writes a constant 1.0 with additive blending into a float
+// target (R32F, else R16F) under the normal depth state, so each pixel ends up holding the
+// number of fragments blended into it. The counts are read back into per-window mean/max,
+// the covered fraction and min/mean over covered pixels, and shown as a heat map in place of the scene: blue 1, green 2, yellow 4,
+// red 8, white OD_HEAT_MAX and up, nothing where no fragment landed. The readback stalls
+// the pipeline, so frame times in this mode are not representative.
+#define OD_HEAT_MAX 16.0f
+#define OD_REPORT_FRAMES 300 // windowed runs report this often; every window reports when closed
+
+struct OverdrawTarget {
+    GLuint fbo, colorRb, depthRb; int w, h;
+    float* counts; unsigned char* rgba;
+    double meanSum, coveredSum, coveredMeanSum; float coveredMin, max; int frames; // whole run; coveredMin 0 = nothing drawn yet
+};
+
+static struct { int loaded; HlGenFn genFramebuffers, genRenderbuffers; HlDeleteFn deleteFramebuffers, deleteRenderbuffers; HlBindFn bindFramebuffer, bindRenderbuffer; HlStorageFn renderbufferStorage; HlAttachFn framebufferRenderbuffer; HlStatusFn checkFramebufferStatus; } g_od;
+static int g_overdrawPass; // set while draw_shape should count instead of shade
+
+static HlProc gl_proc(const char* name){
+#ifdef ORNAMENT_HAS_HEADLESS
+    if(g_hl.getProc) return g_hl.getProc(name);
+#endif
+    return (HlProc)glfwGetProcAddress(name);
+}
+
+static int overdraw_load(void){
+    if(g_od.loaded) return g_od.loaded>0;
+    g_od.genFramebuffers=(HlGenFn)gl_proc("glGenFramebuffers");
+    g_od.genRenderbuffers=(HlGenFn)gl_proc("glGenRenderbuffers");
+    g_od.deleteFramebuffers=(HlDeleteFn)gl_proc("glDeleteFramebuffers");
+    g_od.deleteRenderbuffers=(HlDeleteFn)gl_proc("glDeleteRenderbuffers");
+    g_od.bindFramebuffer=(HlBindFn)gl_proc("glBindFramebuffer");
+    g_od.bindRenderbuffer=(HlBindFn)gl_proc("glBindRenderbuffer");
+    g_od.renderbufferStorage=(HlStorageFn)gl_proc("glRenderbufferStorage");
+    g_od.framebufferRenderbuffer=(HlAttachFn)gl_proc("glFramebufferRenderbuffer");
+    g_od.checkFramebufferStatus=(HlStatusFn)gl_proc("glCheckFramebufferStatus");
+    int ok=g_od.genFramebuffers && g_od.genRenderbuffers && g_od.deleteFramebuffers && g_od.deleteRenderbuffers && g_od.bindFramebuffer
+        && g_od.bindRenderbuffer && g_od.renderbufferStorage && g_od.framebufferRenderbuffer && g_od.checkFramebufferStatus;
+    if(!ok) fprintf(stderr,"warn: --debug-overdraw needs framebuffer objects; drawing normally\n");
+    g_od.loaded=ok? 1 : -1;
+    return ok;
+}
+
+static void overdraw_free_gl(OverdrawTarget* o){
+    if(o->fbo){ g_od.deleteFramebuffers(1,&o->fbo); g_od.deleteRenderbuffers(1,&o->colorRb); g_od.deleteRenderbuffers(1,&o->depthRb); }
+    o->fbo=o->colorRb=o->depthRb=0; o->w=o->h=0;
+}
+
+// (Re)makes the counting target at WxH in the current context: R32F, or R16F (exact to 2048).
+static int overdraw_target(OverdrawTarget* o, int W, int H){
+    if(o->fbo && o->w==W && o->h==H) return 1;
+    overdraw_free_gl(o);
+    float* counts=(float*)realloc(o->counts, sizeof(float)*(size_t)W*(size_t)H); if(counts) o->counts=counts;
+    unsigned char* rgba=(unsigned char*)realloc(o->rgba, 4*(size_t)W*(size_t)H); if(rgba) o->rgba=rgba;
+    if(!counts || !rgba) return 0;
+    static const GLenum formats[2]={ GL_R32F, GL_R16F };
+    g_od.genFramebuffers(1,&o->fbo); g_od.genRenderbuffers(1,&o->colorRb); g_od.genRenderbuffers(1,&o->depthRb);
+    g_od.bindRenderbuffer(GL_RENDERBUFFER, o->depthRb); g_od.renderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, W, H);
+    g_od.bindFramebuffer(GL_FRAMEBUFFER, o->fbo);
+    g_od.framebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, o->depthRb);
+    for(int f=0;f<2;f++){
+        g_od.bindRenderbuffer(GL_RENDERBUFFER, o->colorRb); g_od.renderbufferStorage(GL_RENDERBUFFER, formats[f], W, H);
+        g_od.framebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, o->colorRb);
+        if(g_od.checkFramebufferStatus(GL_FRAMEBUFFER)==GL_FRAMEBUFFER_COMPLETE){ o->w=W; o->h=H; return 1; }
+    }
+    overdraw_free_gl(o);
+    return 0;
+}
+
+// Redirects this window's draw into its counting target. Returns 0 (draw normally) when the
+// context cannot count; --debug-overdraw is then dropped for the run.
+static int overdraw_begin(ScreenWindow* sw, int W, int H, int* enabled){
+    if(!overdraw_load()){ *enabled=0; return 0; }
+    if(!sw->od){ sw->od=(OverdrawTarget*)calloc(1, sizeof(OverdrawTarget)); if(!sw->od){ *enabled=0; return 0; } }
+    if(!overdraw_target(sw->od, W, H)){
+        fprintf(stderr,"warn: --debug-overdraw: no R32F/R16F render target; drawing normally\n");
+        g_od.bindFramebuffer(GL_FRAMEBUFFER, sw->win? 0 : sw->fbo); *enabled=0; return 0;
+    }
+    glClearColor(0,0,0,0); glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
+    g_overdrawPass=1;
+    return 1;
+}
+
+static void overdraw_report(const ScreenWindow* sw, int w){
+    const OverdrawTarget* o=sw->od; if(!o || !o->frames) return;
+    double n=(double)o->frames;
+    fprintf(stderr,"[ornament] overdraw window %d (%dx%d, %d frames): fragments/pixel mean %.3f max %.0f; %.1f%% of pixels covered, min %.0f mean %.2f on those\n",
+            w, o->w, o->h, o->frames, o->meanSum/n, o->max, 100.0*o->coveredSum/n, o->coveredMin, o->coveredMeanSum/n);
+}
+
+static void heat_color(float v, unsigned char* out){
+    static const float stops[5][3]={ {0,0,1}, {0,1,0}, {1,1,0}, {1,0,0}, {1,1,1} }; // 1, 2, 4, 8, 16 fragments
+    if(v<=0.0f){ out[0]=out[1]=out[2]=out[3]=0; return; }
+    float s=log2f(v<OD_HEAT_MAX? v : OD_HEAT_MAX); if(s<0) s=0;
+    int k=(int)s; if(k>3) k=3; float t=s-(float)k;
+    for(int c=0;c<3;c++) out[c]=(unsigned char)(255.0f*(stops[k][c]+(stops[k+1][c]-stops[k][c])*t));
+    out[3]=255;
+}
+
+// Reads the counts back, folds them into the window's totals and draws the heat map into
+// the window's real target.
+static void overdraw_end(ScreenWindow* sw, int w, int report){
+    OverdrawTarget* o=sw->od; int W=o->w, H=o->h; size_t n=(size_t)W*(size_t)H;
+    g_overdrawPass=0;
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0,0,W,H,GL_RED,GL_FLOAT,o->counts);
+    float mn=0, mx=0; double sum=0; size_t covered=0; // mn: over covered pixels only
+    for(size_t i=0;i<n;i++){
+        float v=o->counts[i]; sum+=v; covered+=v>0;
+        if(v>0 && (mn==0 || v<mn)) mn=v;
+        mx=v>mx? v : mx;
+        heat_color(v, &o->rgba[4*i]);
+    }
+    if(mn>0 && (o->coveredMin==0 || mn<o->coveredMin)) o->coveredMin=mn;
+    if(!o->frames || mx>o->max) o->max=mx;
+    o->meanSum+=sum/(double)n; o->coveredSum+=(double)covered/(double)n; o->coveredMeanSum+=covered? sum/(double)covered : 0.0; o->frames++;
+
+    g_od.bindFramebuffer(GL_FRAMEBUFFER, sw->win? 0 : sw->fbo);
+    glViewport(0,0,W,H);
+    glClearColor(0,0,0,0); glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
+    glDisable(GL_DEPTH_TEST); glDisable(GL_BLEND);
+    glMatrixMode(GL_PROJECTION); glLoadIdentity(); glMatrixMode(GL_MODELVIEW); glLoadIdentity();
+    glRasterPos2f(-1.0f,-1.0f); glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glDrawPixels(W,H,GL_RGBA,GL_UNSIGNED_BYTE,o->rgba);
+    if(report) overdraw_report(sw, w);
+}
+
+// Reports and frees the window's counting target; its context must be current.
+static void overdraw_release(ScreenWindow* sw, int w){
+    OverdrawTarget* o=sw->od; if(!o) return;
+    overdraw_report(sw, w);
+    if(g_od.loaded>0) overdraw_free_gl(o);
+    free(o->counts); free(o->rgba); free(o); sw->od=NULL;
+}
+
+// --------------------------- Run statistics ---------------------------
+typedef struct {
+    int frames;
+    uint64_t updateUs, drawUs, presentUs; // CPU wall time per phase, summed over frames
+    long long edges;                      // line segments submitted (all passes, all windows)
+    long long simSteps;                   // fixed-rate simulation steps taken
+    double wallSec;
+} FrameStats;
+
+static long peak_rss_kb(void){
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc; if(K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return (long)(pmc.PeakWorkingSetSize/1024); return 0;
+#else
+    struct rusage ru; if(getrusage(RUSAGE_SELF, &ru)!=0) return 0;
+#ifdef __APPLE__
+    return (long)(ru.ru_maxrss/1024); // bytes on macOS
+#else
+    return (long)ru.ru_maxrss;
+#endif
+#endif
+}
+
+static void json_write_str(FILE* f, const char* str){
+    fputc('"', f);
+    for(; *str; str++){ if(*str=='"'||*str=='\\') fputc('\\', f); if((unsigned char)*str>=0x20) fputc(*str, f); }
+    fputc('"', f);
+}
+
+static void write_stats_json(const char* path, const FrameStats* st, const ScreenSet* scr, int shapeCount, const Options* opt){
+    FILE* f=fopen(path,"wb"); if(!f){ fprintf(stderr,"[ornament] cannot write stats to %s\n", path); return; }
+    double n = st->frames>0? (double)st->frames : 1.0;
+    fputs("{\"config\":", f); json_write_str(f, opt->iniPath);
+    fprintf(f,",\"seed\":%llu,\"shapes\":%d,\"screens\":%d,\"headless\":%d,\"width\":%d,\"height\":%d,\"frames\":%d,",
+            (unsigned long long)opt->seed, shapeCount, scr->count, opt->headless, scr->count? scr->arr[0].width : 0, scr->count? scr->arr[0].height : 0, st->frames);
+    fprintf(f,"\"wall_s\":%.6f,\"fps\":%.3f,\"update_ms\":%.6f,\"draw_ms\":%.6f,\"present_ms\":%.6f,\"edges_per_frame\":%.1f,\"sim_hz\":%d,\"sim_steps\":%lld,\"arena_kb\":%lld,\"peak_rss_kb\":%ld",
+            st->wallSec, st->wallSec>0? st->frames/st->wallSec : 0.0, st->updateUs/n/1000.0, st->drawUs/n/1000.0, st->presentUs/n/1000.0, (double)st->edges/n, opt->simHz, st->simSteps, (long long)atomic_load(&g_arenaReserved)/1024, peak_rss_kb());
+    if(opt->debugOverdraw){
+        fputs(",\"overdraw\":[", f);
+        for(int w=0, first=1; w<scr->count; w++){
+            const OverdrawTarget* o=scr->arr[w].od; if(!o || !o->frames) continue;
+            double k=(double)o->frames;
+            fprintf(f,"%s{\"window\":%d,\"mean\":%.6f,\"max\":%.0f,\"covered_pct\":%.3f,\"covered_min\":%.0f,\"covered_mean\":%.6f}", first? "" : ",", w, o->meanSum/k, o->max, 100.0*o->coveredSum/k, o->coveredMin, o->coveredMeanSum/k);
+            first=0;
+        }
+        fputc(']', f);
+    }
+    fputs("}\n", f);
+    fclose(f);
+}
+
+// --------------------------- Session record / replay ---------------------------
+// A session pins down everything the animation depends on: seed, config, screen layout, the
+// timeline options (--sim-hz, --anim, --start-time, --trig, --layout) and the dt each frame fed
+// to the simulation. Replaying it adopts the recorded options and re-runs the identical
+// timeline, so two builds can be compared on the same workload. File layout (native byte order):
+//   SessionHeader, screenCount x SessionScreen, frameCount x float dt
+#define SESSION_MAGIC "ORNSESS1"
+#define SESSION_VERSION 2 // 2: timeline options; version 1 files are refused
+#define SESSION_ANALYTIC 1u       // flags: --anim analytic
+#define SESSION_TRIG_LIBM 2u      //        --trig libm
+#define SESSION_LAYOUT_STACKED 4u //        --layout stacked
+typedef struct {
+    char magic[8]; uint32_t version, screenCount; uint64_t seed, configHash; uint32_t frameCount, reserved;
+    uint32_t simHz, flags; double startTime;
+} SessionHeader;
+typedef struct { int32_t monIndex, width, height; } SessionScreen;
+
+typedef struct {
+    SessionHeader hdr;
+    SessionScreen* screens;
+    float* dt; int cursor;          // replay
+    FILE* out;                      // record
+} Session;
+
+#define FNV1A_INIT 0xCBF29CE484222325ull
+static uint64_t fnv1a64(uint64_t h, const void* data, size_t n){
+    const unsigned char* b=(const unsigned char*)data;
+    for(size_t i=0;i<n;i++){ h^=b[i]; h*=0x100000001B3ull; }
+    return h;
+}
+
+// FNV-1a 64 over the raw config file; 0 when it cannot be read
+static uint64_t hash_file(const char* path){
+    FILE* f=fopen(path,"rb"); if(!f) return 0;
+    uint64_t h=FNV1A_INIT; unsigned char buf[4096]; size_t n;
+    while((n=fread(buf,1,sizeof(buf),f))>0) h=fnv1a64(h,buf,n);
+    fclose(f); return h;
+}
+
+static int session_load(Session* s, const char* path){
+    memset(s,0,sizeof(*s));
+    FILE* f=fopen(path,"rb"); if(!f){ fprintf(stderr,"[ornament] cannot open session %s\n", path); return 0; }
+    size_t got=fread(&s->hdr,1,sizeof(s->hdr),f);
+    if(got<12 || memcmp(s->hdr.magic,SESSION_MAGIC,8)!=0){ fprintf(stderr,"[ornament] %s is not a session file\n", path); fclose(f); return 0; }
+    if(s->hdr.version!=SESSION_VERSION){ fprintf(stderr,"[ornament] %s: session version %u is not supported (re-record it)\n", path, s->hdr.version); fclose(f); return 0; }
+    if(got!=sizeof(s->hdr) || s->hdr.simHz<1 || s->hdr.simHz>1000 || !isfinite(s->hdr.startTime)){ fprintf(stderr,"[ornament] %s: bad session header\n", path); fclose(f); return 0; }
+    if(s->hdr.screenCount>HEADLESS_MAX_SCREENS){ fprintf(stderr,"[ornament] %s: bad screen count %u\n", path, s->hdr.screenCount); fclose(f); return 0; }
+    s->screens=(SessionScreen*)calloc(s->hdr.screenCount+1, sizeof(SessionScreen));
+    if(!s->screens || fread(s->screens,sizeof(SessionScreen),s->hdr.screenCount,f)!=s->hdr.screenCount){
+        fprintf(stderr,"[ornament] truncated session %s\n", path); fclose(f); free(s->screens); s->screens=NULL; return 0;
+    }
+    // frameCount is patched in on a clean exit; an interrupted recording is read up to EOF
+    long pos=ftell(f); fseek(f,0,SEEK_END); long avail=(ftell(f)-pos)/(long)sizeof(float); fseek(f,pos,SEEK_SET);
+    if(s->hdr.frameCount==0 || (long)s->hdr.frameCount>avail) s->hdr.frameCount=(uint32_t)avail;
+    s->dt=(float*)malloc(sizeof(float)*((size_t)s->hdr.frameCount+1));
+    if(!s->dt){ fprintf(stderr,"[ornament] out of memory reading %s\n", path); fclose(f); free(s->screens); s->screens=NULL; return 0; }
+    s->hdr.frameCount=(uint32_t)fread(s->dt,sizeof(float),s->hdr.frameCount,f);
+    fclose(f);
+    return 1;
+}
+
+static int session_begin_record(Session* s, const char* path, const Options* opt, uint64_t configHash, const ScreenSet* scr){
+    memset(s,0,sizeof(*s));
+    s->out=fopen(path,"wb"); if(!s->out){ fprintf(stderr,"[ornament] cannot write session %s\n", path); return 0; }
+    memcpy(s->hdr.magic,SESSION_MAGIC,8); s->hdr.version=SESSION_VERSION; s->hdr.seed=opt->seed; s->hdr.configHash=configHash; s->hdr.screenCount=(uint32_t)scr->count;
+    s->hdr.simHz=(uint32_t)opt->simHz; s->hdr.startTime=opt->analytic? opt->startTime : 0.0;
+    s->hdr.flags=(opt->analytic? SESSION_ANALYTIC : 0u) | (g_trigLibm? SESSION_TRIG_LIBM : 0u) | (g_layoutStacked? SESSION_LAYOUT_STACKED : 0u);
+    fwrite(&s->hdr,sizeof(s->hdr),1,s->out);
+    for(int i=0;i<scr->count;i++){ SessionScreen ss={ scr->arr[i].monIndex, scr->arr[i].width, scr->arr[i].height }; fwrite(&ss,sizeof(ss),1,s->out); }
+    return 1;
+}
+
+static void session_record_dt(Session* s, float dt){ if(s->out){ fwrite(&dt,sizeof(dt),1,s->out); s->hdr.frameCount++; } }
+
+// Returns 0 when the recorded timeline is exhausted.
+static int session_next_dt(Session* s, float* dt){ if(s->cursor>=(int)s->hdr.frameCount) return 0; *dt=s->dt[s->cursor++]; return 1; }
+
+static const SessionScreen* session_screen(const Session* s, int monIndex){
+    for(uint32_t i=0;i<s->hdr.screenCount;i++) if(s->screens[i].monIndex==monIndex) return &s->screens[i];
+    return NULL;
+}
+
+static void session_close(Session* s){
+    if(s->out){ fseek(s->out,0,SEEK_SET); fwrite(&s->hdr,sizeof(s->hdr),1,s->out); fclose(s->out); }
+    free(s->screens); free(s->dt); memset(s,0,sizeof(*s));
+}
+
+// --------------------------- Layout ---------------------------
+// Shapes are placed on the z=0 plane the camera looks at. Each screen keeps a coarse coverage
+// grid counting the bounding circles over every cell. A shape tries its anchor point first,
+// then a lattice over its anchor's third of the screen, nearest first, and takes the spot whose
+// circle covers the least existing coverage; an overlap-free spot ends the search. After the
+// greedy pass (file order) every shape is lifted out and re-placed against all the others for
+// LAYOUT_PASSES-1 more passes, which undoes most of the order dependence. Grid rows are kept as
+// prefix sums and circles as per-row spans, so a probe costs one subtraction per row and
+// crowded screens with thousands of shapes stay cheap. The summed coverage over covered cells
+// is the bounding-circle overdraw factor (1.0 = nothing overlaps).
+// --layout stacked keeps the old fixed diagonal step per extra shape on an anchor.
+#define SHAPE_SCALE 0.6f
+// Bounding-sphere radius of each mesh at scale 1 about its origin: however a shape spins, its
+// projection stays inside this circle (x SHAPE_SCALE x SCALE=).
+static const float SHAPE_RADIUS[SH_COUNT] = { 0.866f, 0.5f, 0.8f, 0.5f, 1.0f }; // cube, sphere, pyramid, torus, octahedron
+#define LAYOUT_GRID 32       // coverage cells per side
+#define LAYOUT_EXTENT 1.6f   // the grid spans [-E,E]^2: anchors sit within +-1, circles reach past
+#define LAYOUT_LATTICE 7     // candidate spots per axis within an anchor's region
+#define LAYOUT_CANDIDATES (1+LAYOUT_LATTICE*LAYOUT_LATTICE)
+#define LAYOUT_PASSES 3
+
+typedef struct { float overdraw, stackedOverdraw; double ms; } LayoutStats;
+
+// One screen: rows of LAYOUT_GRID+1 prefix sums, row[x] = coverage of cells [0,x).
+typedef uint32_t CoverRow[LAYOUT_GRID+1];
+// A circle rasterised around its centre cell: cells (dx,dy) with dx^2+dy^2 <= (r/cell)^2.
+typedef struct { int cx, cy, rows; int half[LAYOUT_GRID]; } CellCircle;
+
+static int cell_of(float v){ int c=(int)floorf((v+LAYOUT_EXTENT)*(LAYOUT_GRID/(2*LAYOUT_EXTENT))); return CLAMP(c,0,LAYOUT_GRID-1); }
+static int on_grid(vec3 p){ return fabsf(p.x)<LAYOUT_EXTENT && fabsf(p.y)<LAYOUT_EXTENT; }
+
+static void cell_circle(CellCircle* c, float r){
+    float rc=r*(LAYOUT_GRID/(2*LAYOUT_EXTENT)); int rows=(int)rc; if(rows>LAYOUT_GRID-1) rows=LAYOUT_GRID-1;
+    c->rows=rows;
+    for(int dy=0;dy<=rows;dy++) c->half[dy]=(int)sqrtf(rc*rc-(float)(dy*dy));
+}
+
+// Coverage under circle `c` centred on cell (cx,cy); stops once it reaches `limit`.
+static uint32_t cover_cost(CoverRow* g, const CellCircle* c, int cx, int cy, uint32_t limit){
+    uint32_t sum=0;
+    for(int dy=-c->rows;dy<=c->rows;dy++){
+        int y=cy+dy; if(y<0 || y>=LAYOUT_GRID) continue;
+        int h=c->half[dy<0? -dy : dy], xa=cx-h<0? 0 : cx-h, xb=cx+h>=LAYOUT_GRID? LAYOUT_GRID-1 : cx+h;
+        sum+=g[y][xb+1]-g[y][xa];
+        if(sum>=limit) break;
+    }
+    return sum;
+}
+static void cover_add(CoverRow* g, const CellCircle* c, int cx, int cy, int delta){
+    for(int dy=-c->rows;dy<=c->rows;dy++){
+        int y=cy+dy; if(y<0 || y>=LAYOUT_GRID) continue;
+        int h=c->half[dy<0? -dy : dy], xa=cx-h<0? 0 : cx-h, xb=cx+h>=LAYOUT_GRID? LAYOUT_GRID-1 : cx+h;
+        for(int j=xa+1;j<=LAYOUT_GRID;j++) g[y][j]+=(uint32_t)(delta*((j<=xb+1? j : xb+1)-xa));
+    }
+}
+
+static void coverage_sum(CoverRow* g, double* sum, double* covered){
+    for(int y=0;y<LAYOUT_GRID;y++) for(int x=0;x<LAYOUT_GRID;x++){ uint32_t v=g[y][x+1]-g[y][x]; if(v){ *sum+=v; *covered+=1; } }
+}
+
+// Candidate spots for each anchor: the anchor point, then its region's lattice by distance.
+static void layout_candidates(vec3 cand[POS_COUNT][LAYOUT_CANDIDATES]){
+    for(int a=0;a<POS_COUNT;a++){
+        vec3 anc=anchor_to_ndc((Anchor)a), p0=anchor_margin(anc, 0.12f);
+        float rx=-1.0f+(anc.x+1.0f)*(2.0f/3.0f), ry=-1.0f+(anc.y+1.0f)*(2.0f/3.0f); // region's lower-left corner
+        int n=0; cand[a][n++]=p0;
+        for(int j=0;j<LAYOUT_LATTICE;j++) for(int i=0;i<LAYOUT_LATTICE;i++)
+            cand[a][n++]=v3(rx+((float)i+0.5f)*(2.0f/3.0f)/LAYOUT_LATTICE, ry+((float)j+0.5f)*(2.0f/3.0f)/LAYOUT_LATTICE, 0);
+        for(int i=2;i<n;i++){ // insertion sort by distance to p0 (49 entries, once per call)
+            vec3 v=cand[a][i]; float d=v3_len(v3_sub(v,p0)); int k=i;
+            while(k>1 && v3_len(v3_sub(cand[a][k-1],p0))>d){ cand[a][k]=cand[a][k-1]; k--; }
+            cand[a][k]=v;
+        }
+    }
+}
+
+// Least-covered candidate for a shape on anchor `a`; the first overlap-free one wins outright.
+static vec3 layout_best(CoverRow* g, const CellCircle* c, const vec3* cand){
+    uint32_t best=UINT32_MAX; vec3 pos=cand[0];
+    for(int k=0;k<LAYOUT_CANDIDATES && best>0;k++){
+        uint32_t cost=cover_cost(g, c, cell_of(cand[k].x), cell_of(cand[k].y), best);
+        if(cost<best){ best=cost; pos=cand[k]; }
+    }
+    return pos;
+}
+
+// Shared by main, hot reload and --compile-config. Screens past monCount fold onto the last
+// one. `st` (optional) receives the overdraw reached and what the fixed step would give.
+static void place_shapes(const ShapeList* L, int monCount, vec3* out, LayoutStats* st){
+    uint64_t t0=time_now_us();
+    if(monCount<1) monCount=1;
+    int* quadrantCount=(int*)calloc((size_t)monCount*POS_COUNT, sizeof(int)); // [monCount][POS_COUNT]
+    CoverRow** grid=(CoverRow**)calloc((size_t)monCount*2, sizeof(CoverRow*)); // [mon][packed, stacked]
+    int* monOf=(int*)malloc(sizeof(int)*(size_t)(L->count+1));
+    static vec3 cand[POS_COUNT][LAYOUT_CANDIDATES]; layout_candidates(cand);
+    int packed=quadrantCount && grid && monOf && !g_layoutStacked;
+    for(int i=0;i<L->count;i++){
+        ShapeConfig sc=L->items[i];
+        int mon=sc.screen; if(mon<0) mon=0; if(mon>=monCount) mon=monCount-1;
+        vec3 anc=anchor_to_ndc(sc.pos);
+        vec3 pos=anchor_margin(anc, 0.12f); // ~6% of each side -> NDC ~0.12
+        if(quadrantCount){
+            int qn=quadrantCount[mon*POS_COUNT+sc.pos]++;
+            float off=0.05f*(float)qn; pos.x += (anc.x>=0? -off: off); pos.y += (anc.y>=0? -off: off);
+        }
+        out[i]=pos;
+        if(!grid || !monOf) continue;
+        monOf[i]=mon;
+        CoverRow** g=&grid[2*mon];
+        if(!g[0]) g[0]=(CoverRow*)calloc(LAYOUT_GRID, sizeof(CoverRow));
+        if(!g[1]) g[1]=(CoverRow*)calloc(LAYOUT_GRID, sizeof(CoverRow));
+        if(!g[0] || !g[1]){ packed=0; continue; }
+        CellCircle c; cell_circle(&c, SHAPE_RADIUS[sc.shape]*SHAPE_SCALE*sc.scale);
+        if(on_grid(pos)) cover_add(g[1], &c, cell_of(pos.x), cell_of(pos.y), 1); // stacked steps run off-screen; those cost no fill
+        if(packed){ out[i]=layout_best(g[0], &c, cand[sc.pos]); cover_add(g[0], &c, cell_of(out[i].x), cell_of(out[i].y), 1); }
+    }
+    for(int pass=1;pass<LAYOUT_PASSES && packed;pass++){
+        for(int i=0;i<L->count;i++){
+            const ShapeConfig* sc=&L->items[i]; CoverRow* g=grid[2*monOf[i]];
+            CellCircle c; cell_circle(&c, SHAPE_RADIUS[sc->shape]*SHAPE_SCALE*sc->scale);
+            cover_add(g, &c, cell_of(out[i].x), cell_of(out[i].y), -1);
+            out[i]=layout_best(g, &c, cand[sc->pos]);
+            cover_add(g, &c, cell_of(out[i].x), cell_of(out[i].y), 1);
+        }
+    }
+    if(st){
+        double sum[2]={0,0}, covered[2]={0,0};
+        if(grid) for(int m=0;m<2*monCount;m++) if(grid[m]) coverage_sum(grid[m], &sum[m&1], &covered[m&1]);
+        st->stackedOverdraw=covered[1]>0? (float)(sum[1]/covered[1]) : 1.0f;
+        st->overdraw=!packed? st->stackedOverdraw : covered[0]>0? (float)(sum[0]/covered[0]) : 1.0f;
+        st->ms=(double)(time_now_us()-t0)/1000.0;
+    }
+    if(grid) for(int m=0;m<2*monCount;m++) free(grid[m]);
+    free(grid); free(quadrantCount); free(monOf);
+}
+
+// --------------------------- Compiled scene (.orn) ---------------------------
+// --compile-config writes everything startup derives from the INI into one binary file, so
+// --scene can map it and go straight to window creation: no text parsing, no placement, and
+// (unless --no-meshes) no geometry. Layout (native byte order, offsets from file start):
+//   SceneHeader | shapeCount x SceneShape | meshCount x SceneMesh | mesh data (16-aligned)
+// The checksum covers everything after the header.
+#define SCENE_MAGIC "ORNSCEN1"
+#define SCENE_VERSION 2
+#define SCENE_ENDIAN 0x01020304u
+#define SCENE_MESHES 1u // header flag: mesh section present
+typedef struct {
+    char magic[8]; uint32_t version, endian;
+    uint32_t shapeCount, meshCount, flags, placedScreens; // placedScreens: screen count the positions were resolved for
+    uint64_t configHash;   // hash_file of the source INI, so sessions recorded either way stay comparable
+    uint64_t payloadBytes, checksum;
+    uint32_t reserved[2];
+} SceneHeader;
+typedef struct { uint8_t shape, color, pos, lod; int32_t screen; float x, y; int32_t mesh; uint8_t glow, pad[3]; float width, spin, scale; } SceneShape;
+typedef struct { uint8_t shape, lod, pad[2]; int32_t vcount, lcount; uint32_t vertOfs, lineOfs, reserved; } SceneMesh;
+
+typedef struct { MappedFile mf; const SceneHeader* hdr; const SceneShape* shapes; const SceneMesh* meshes; } SceneFile;
+
+static int scene_screen_count(const ShapeList* L){
+    int n=0; for(int i=0;i<L->count;i++) if(L->items[i].screen+1>n) n=L->items[i].screen+1;
+    return CLAMP(n,1,HEADLESS_MAX_SCREENS);
+}
+
+static size_t align16(size_t n){ return (n+15)&~(size_t)15; }
+
+static int compile_scene(const char* iniPath, const char* outPath, int withMeshes){
+    Arena ar={0};
+    ShapeList L=load_ini(iniPath, &ar);
+    int screens=scene_screen_count(&L);
+    vec3* pos=(vec3*)arena_alloc(&ar, sizeof(vec3)*(size_t)L.count, 16);
+    LayoutStats ls={0};
+    place_shapes(&L, screens, pos, &ls);
+
+    // one mesh per (shape, lod) actually used
+    int meshOf[SH_COUNT][MESH_LODS]; memset(meshOf,-1,sizeof(meshOf));
+    WireGeom geom[SH_COUNT*MESH_LODS]; SceneMesh meshes[SH_COUNT*MESH_LODS]; int mc=0;
+    SceneShape* recs=(SceneShape*)arena_calloc(&ar, (size_t)L.count, sizeof(SceneShape), 8);
+    if(!pos || !recs){ fprintf(stderr,"Out of memory\n"); arena_free(&ar); return 0; }
+    for(int i=0;i<L.count;i++){
+        const ShapeConfig* sc=&L.items[i]; int lod=sc->lod;
+        if(withMeshes && meshOf[sc->shape][lod]<0){
+            geom[mc]=make_shape_geom(&ar, sc->shape, lod);
+            meshes[mc]=(SceneMesh){ (uint8_t)sc->shape, (uint8_t)lod, {0,0}, geom[mc].vcount, geom[mc].lcount, 0, 0, 0 };
+            meshOf[sc->shape][lod]=mc++;
+        }
+        recs[i]=(SceneShape){ (uint8_t)sc->shape, (uint8_t)sc->color, (uint8_t)sc->pos, (uint8_t)lod, sc->screen, pos[i].x, pos[i].y, withMeshes? meshOf[sc->shape][lod] : -1,
+                              (uint8_t)sc->glow, {0,0,0}, sc->width, sc->spin, sc->scale };
+    }
+    size_t ofs=align16(sizeof(SceneHeader)+sizeof(SceneShape)*(size_t)L.count+sizeof(SceneMesh)*(size_t)mc);
+    for(int m=0;m<mc;m++){
+        meshes[m].vertOfs=(uint32_t)ofs; ofs=align16(ofs+sizeof(vec3)*(size_t)geom[m].vcount);
+        meshes[m].lineOfs=(uint32_t)ofs; ofs=align16(ofs+sizeof(unsigned)*2*(size_t)geom[m].lcount);
+    }
+
+    // assemble the payload in memory so the checksum can be written up front
+    size_t total=ofs;
+    unsigned char* buf=(unsigned char*)calloc(1,total);
+    if(!buf){ fprintf(stderr,"Out of memory\n"); arena_free(&ar); return 0; }
+    SceneHeader* h=(SceneHeader*)buf;
+    memcpy(h->magic,SCENE_MAGIC,8); h->version=SCENE_VERSION; h->endian=SCENE_ENDIAN;
+    h->shapeCount=(uint32_t)L.count; h->meshCount=(uint32_t)mc; h->flags=withMeshes? SCENE_MESHES : 0; h->placedScreens=(uint32_t)screens;
+    h->configHash=hash_file(iniPath); h->payloadBytes=total-sizeof(SceneHeader);
+    unsigned char* p=buf+sizeof(SceneHeader);
+    memcpy(p, recs, sizeof(SceneShape)*(size_t)L.count); p+=sizeof(SceneShape)*(size_t)L.count;
+    memcpy(p, meshes, sizeof(SceneMesh)*(size_t)mc);
+    for(int m=0;m<mc;m++){
+        memcpy(buf+meshes[m].vertOfs, geom[m].verts, sizeof(vec3)*(size_t)geom[m].vcount);
+        memcpy(buf+meshes[m].lineOfs, geom[m].lines, sizeof(unsigned)*2*(size_t)geom[m].lcount);
+    }
+    h->checksum=fnv1a64(FNV1A_INIT, buf+sizeof(SceneHeader), (size_t)h->payloadBytes);
+
+    FILE* f=fopen(outPath,"wb"); int ok=0;
+    if(!f) fprintf(stderr,"[ornament] cannot write scene %s\n", outPath);
+    else { ok=fwrite(buf,1,total,f)==total; if(fclose(f)!=0) ok=0; if(!ok) fprintf(stderr,"[ornament] write failed for %s\n", outPath); }
+    if(ok) fprintf(stderr,"[ornament] %s: %d shapes, %d meshes, %zu bytes, layout overdraw %.2fx\n", outPath, L.count, mc, total, ls.overdraw);
+    free(buf); arena_free(&ar);
+    return ok;
+}
+
+// Maps and validates a compiled scene. Everything is checked before any pointer into the
+// mapping is handed out; the mapping stays alive until scene_close (meshes are used in place).
+static int scene_open(SceneFile* sf, const char* path){
+    memset(sf,0,sizeof(*sf));
+    if(!map_file(path, &sf->mf)){ fprintf(stderr,"[ornament] cannot open scene %s\n", path); return 0; }
+    const char* why=NULL;
+    const SceneHeader* h=(const SceneHeader*)sf->mf.data;
+    size_t size=sf->mf.size;
+    if(size<sizeof(SceneHeader) || memcmp(h->magic,SCENE_MAGIC,8)!=0) why="not a compiled scene";
+    else if(h->version!=SCENE_VERSION) why="unsupported scene version (recompile it)";
+    else if(h->endian!=SCENE_ENDIAN) why="scene was compiled on a machine with different byte order";
+    else if(h->payloadBytes!=size-sizeof(SceneHeader) || h->shapeCount==0 || h->meshCount>SH_COUNT*MESH_LODS
+        || sizeof(SceneShape)*(uint64_t)h->shapeCount+sizeof(SceneMesh)*(uint64_t)h->meshCount>h->payloadBytes) why="truncated or malformed scene";
+    else if(fnv1a64(FNV1A_INIT, sf->mf.data+sizeof(SceneHeader), (size_t)h->payloadBytes)!=h->checksum) why="checksum mismatch";
+    if(!why){
+        sf->shapes=(const SceneShape*)(sf->mf.data+sizeof(SceneHeader));
+        sf->meshes=(const SceneMesh*)(sf->shapes+h->shapeCount);
+        uint64_t dataStart=sizeof(SceneHeader)+sizeof(SceneShape)*(uint64_t)h->shapeCount+sizeof(SceneMesh)*(uint64_t)h->meshCount;
+        for(uint32_t m=0;m<h->meshCount && !why;m++){
+            const SceneMesh* sm=&sf->meshes[m];
+            if(sm->vcount<=0 || sm->lcount<0 || (sm->vertOfs|sm->lineOfs)&15 || sm->vertOfs<dataStart || sm->lineOfs<dataStart
+                || sm->vertOfs+sizeof(vec3)*(uint64_t)sm->vcount>size || sm->lineOfs+sizeof(unsigned)*2*(uint64_t)sm->lcount>size){ why="mesh out of bounds"; break; }
+            const unsigned* e=(const unsigned*)(sf->mf.data+sm->lineOfs);
+            for(int k=0;k<2*sm->lcount;k++) if(e[k]>=(unsigned)sm->vcount){ why="mesh index out of range"; break; }
+        }
+        for(uint32_t i=0;i<h->shapeCount && !why;i++){
+            const SceneShape* r=&sf->shapes[i];
+            if(r->shape>=SH_COUNT || r->color>=COL_COUNT || r->pos>=POS_COUNT || r->lod>=MESH_LODS || r->mesh>=(int32_t)h->meshCount
+                || r->glow<1 || r->glow>GLOW_MAX_PASSES || !(r->width>0) || !(r->spin>0) || !(r->scale>0)) why="bad shape record";
+            else if(r->mesh>=0 && (sf->meshes[r->mesh].shape!=r->shape || sf->meshes[r->mesh].lod!=r->lod)) why="shape record points at another shape's mesh";
+        }
+    }
+    if(why){ fprintf(stderr,"[ornament] %s: %s\n", path, why); unmap_file(&sf->mf); return 0; }
+    sf->hdr=h;
+    return 1;
+}
+
+static ShapeList scene_shape_list(const SceneFile* sf, Arena* ar){
+    ShapeList L={ (int)sf->hdr->shapeCount, (ShapeConfig*)arena_alloc(ar, sizeof(ShapeConfig)*sf->hdr->shapeCount, 8) };
+    for(int i=0;i<L.count && L.items;i++){
+        const SceneShape* r=&sf->shapes[i]; ShapeConfig c=shape_config((ShapeKind)r->shape, (ColorKind)r->color, (Anchor)r->pos, r->screen);
+        c.lod=r->lod; c.glow=r->glow; c.width=r->width; c.spin=r->spin; c.scale=r->scale;
+        L.items[i]=c;
+    }
+    return L;
+}
+
+// WireGeom straight out of the mapping; {0} when the record has no embedded mesh
+static WireGeom scene_mesh(const SceneFile* sf, int shapeIdx){
+    WireGeom g={0}; int m=sf->shapes[shapeIdx].mesh; if(m<0) return g;
+    const SceneMesh* sm=&sf->meshes[m];
+    g.verts=(const vec3*)(sf->mf.data+sm->vertOfs); g.lines=(const unsigned*)(sf->mf.data+sm->lineOfs);
+    g.vcount=sm->vcount; g.lcount=sm->lcount;
+    return g;
+}
+
+static void scene_close(SceneFile* sf){ unmap_file(&sf->mf); memset(sf,0,sizeof(*sf)); }
 
 // Forward decl
-static void app_loop(ScreenSet* scr, ShapeRuntime* runtime, int runtimeCount, float brightness, float thickness, int fpsCap, int vsync);
+typedef struct ShapeSet ShapeSet;
+static void app_loop(ScreenSet* scr, ShapeSet* shapes, Options* opt, Session* rec, Session* rep);
+
+// --------------------------- Animation (SoA) ---------------------------
+#define ANIM_FLOAT_STREAMS 20
+
+// Streams come from `ar` when given (released with the arena), otherwise from one malloc.
+static int anim_init(ShapeAnim* a, int count, Arena* ar){
+    memset(a,0,sizeof(*a));
+    int cap = (count + 7) & ~7; if(cap==0) cap=8; // multiple of every SIMD_WIDTH
+    size_t streamBytes = sizeof(float)*(size_t)cap;
+    size_t bytes = streamBytes*ANIM_FLOAT_STREAMS + (sizeof(Rng)+sizeof(KeySeg)+sizeof(uint32_t))*(size_t)cap;
+    char* p;
+    if(ar){ p = (char*)arena_alloc(ar, bytes, SIMD_ALIGN); if(!p) return 0; }
+    else {
+        a->block = malloc(bytes + SIMD_ALIGN); if(!a->block) return 0;
+        p = (char*)(((uintptr_t)a->block + SIMD_ALIGN-1) & ~(uintptr_t)(SIMD_ALIGN-1));
+    }
+    float** streams[ANIM_FLOAT_STREAMS] = { &a->hue, &a->hueSpeed, &a->ox, &a->oy, &a->oz, &a->ow, &a->px, &a->py, &a->pz, &a->pw, &a->tx, &a->ty, &a->tz, &a->tw,
+                                            &a->spinY, &a->spinX, &a->timer, &a->dur, &a->t, &a->period };
+    for(int k=0;k<ANIM_FLOAT_STREAMS;k++){ *streams[k]=(float*)p; p+=streamBytes; }
+    a->rng = (Rng*)p; p += sizeof(Rng)*(size_t)cap;
+    a->seg = (KeySeg*)p; p += sizeof(KeySeg)*(size_t)cap;
+    a->id = (uint32_t*)p;
+    a->count=count; a->cap=cap;
+    // inert lanes: identity orientation, a timer that never fires
+    for(int i=0;i<cap;i++){
+        a->hue[i]=a->hueSpeed[i]=a->spinY[i]=a->spinX[i]=a->t[i]=0.0f;
+        a->ox[i]=a->oy[i]=a->oz[i]=0.0f; a->ow[i]=1.0f; a->px[i]=a->py[i]=a->pz[i]=0.0f; a->pw[i]=1.0f; a->tx[i]=a->ty[i]=a->tz[i]=0.0f; a->tw[i]=1.0f;
+        a->timer[i]=1e30f; a->dur[i]=1.0f; a->period[i]=2.0f; a->rng[i]=rng_seed(0, (uint64_t)i); a->seg[i].k=-1; a->id[i]=(uint32_t)i;
+    }
+    return 1;
+}
+static void anim_free(ShapeAnim* a){ free(a->block); memset(a,0,sizeof(*a)); }
+
+// One shape's full state, possibly between animations of different capacity.
+static void anim_move(ShapeAnim* dst, int di, const ShapeAnim* src, int si){
+    float* d[ANIM_FLOAT_STREAMS] = { dst->hue, dst->hueSpeed, dst->ox, dst->oy, dst->oz, dst->ow, dst->px, dst->py, dst->pz, dst->pw, dst->tx, dst->ty, dst->tz, dst->tw,
+                                     dst->spinY, dst->spinX, dst->timer, dst->dur, dst->t, dst->period };
+    const float* sp[ANIM_FLOAT_STREAMS] = { src->hue, src->hueSpeed, src->ox, src->oy, src->oz, src->ow, src->px, src->py, src->pz, src->pw, src->tx, src->ty, src->tz, src->tw,
+                                            src->spinY, src->spinX, src->timer, src->dur, src->t, src->period };
+    for(int k=0;k<ANIM_FLOAT_STREAMS;k++) d[k][di]=sp[k][si];
+    dst->rng[di]=src->rng[si]; dst->seg[di]=src->seg[si]; dst->id[di]=src->id[si]; dst->seed=src->seed;
+}
 
-// --------------------------- Main ---------------------------
-int main(int argc, char** argv){
-    srand((unsigned)time(NULL));
+static void anim_set_orient(ShapeAnim* a, int i, quat q){ a->ox[i]=q.x; a->oy[i]=q.y; a->oz[i]=q.z; a->ow[i]=q.w; }
+static void anim_set_target(ShapeAnim* a, int i, quat q){ a->tx[i]=q.x; a->ty[i]=q.y; a->tz[i]=q.z; a->tw[i]=q.w; }
+
+// Initial random state for shape i, drawn from stream `id` (the shape's index at startup).
+static void anim_spawn_id(ShapeAnim* a, int i, uint64_t seed, uint32_t id){
+    Rng* r=&a->rng[i]; *r=rng_seed(seed, (uint64_t)id); a->id[i]=id;
+    a->hue[i]=rng_float01(r); a->hueSpeed[i]=rng_range(r,0.25f,0.5f);
+    float ex=rng_range(r,-1,1), ey=rng_range(r,-1,1), ez=rng_range(r,-1,1); // sequenced: argument order is unspecified
+    anim_set_orient(a, i, q_ident()); anim_set_target(a, i, q_from_euler(ex, ey, ez));
+    a->px[i]=a->py[i]=a->pz[i]=0.0f; a->pw[i]=1.0f;
+    a->spinY[i]=rng_range(r,180,360); a->spinX[i]=rng_range(r,15,45);
+    a->timer[i]=rng_range(r,4,8); a->dur[i]=rng_range(r,1.5f,2.5f); a->t[i]=0.0f;
+    a->period[i]=a->timer[i]+a->dur[i]; a->seg[i].k=-1; a->seed=seed;
+}
+// SPIN= knob: scales both spin rates (the random draws themselves are unchanged).
+static void anim_scale_spin(ShapeAnim* a, int i, float k){ a->spinY[i]*=k; a->spinX[i]*=k; }
 
-    const char* iniPath = "./ornament.ini";
-    float brightness = 1.0f; float thickness = 2.0f; int fpsCap = 0; int vsync = 1;
-    for(int i=1;i<argc;i++){
-        if(strcmp(argv[i],"--config")==0 && i+1<argc) iniPath=argv[++i];
-        else if(strcmp(argv[i],"--brightness")==0 && i+1<argc) brightness=(float)atof(argv[++i]);
-        else if(strcmp(argv[i],"--thickness")==0 && i+1<argc) thickness=(float)atof(argv[++i]);
-        else if(strcmp(argv[i],"--fps")==0 && i+1<argc) fpsCap=atoi(argv[++i]);
-        else if(strcmp(argv[i],"--no-vsync")==0) vsync=0;
+static void anim_new_target(ShapeAnim* a, int i){
+    Rng* r=&a->rng[i];
+    float ex=rng_range(r,-1.5f,1.5f), ey=rng_range(r,-1.5f,1.5f), ez=rng_range(r,-1.5f,1.5f);
+    anim_set_target(a, i, q_from_euler(ex, ey, ez));
+}
+
+// Batched update of shapes [begin,end); begin must be a multiple of SIMD_WIDTH. The reorientation
+// branch is resolved with lane masks; only the rare lanes that start or finish a reorientation
+// drop to scalar code for their random draws. Hue is not stepped: color_for is closed-form.
+static void update_shapes(ShapeAnim* a, int begin, int end, float dt){
+    const vf zero=vf_set1(0.0f), one=vf_set1(1.0f), half=vf_set1(0.5f), vdt=vf_set1(dt);
+    const vf halfRadPerDeg=vf_set1(dt*(float)M_PI/180.0f*0.5f);
+    for(int i=begin;i<end;i+=SIMD_WIDTH){
+        vf timer=vf_sub(vf_load(a->timer+i), vdt);
+        vf T=vf_load(a->t+i);
+        vm active=vm_or(vf_le(timer, zero), vf_gt(T, zero));
+        int startBits=vm_bits(vm_and(active, vf_eq(T, zero)));
+        if(startBits) for(int k=0;k<SIMD_WIDTH;k++) if(startBits>>k & 1) anim_new_target(a, i+k);
+        T=vf_sel(active, vf_add(T, vf_div(vdt, vf_load(a->dur+i))), T);
+        vm finish=vm_and(active, vf_ge(T, one));
+        vm sl=vm_andnot(active, finish);
+
+        vquat o={ vf_load(a->ox+i), vf_load(a->oy+i), vf_load(a->oz+i), vf_load(a->ow+i) };
+        vquat tg={ vf_load(a->tx+i), vf_load(a->ty+i), vf_load(a->tz+i), vf_load(a->tw+i) };
+        o=vq_sel(finish, tg, o);
+        if(vm_bits(sl)) o=vq_sel(sl, vq_slerp(o, tg, T), o);
+        vf spinScale=vf_sel(sl, half, one);
+        vf_store(a->t+i, vf_sel(finish, zero, T));
+        vf_store(a->timer+i, timer);
+        int finishBits=vm_bits(finish);
+        if(finishBits) for(int k=0;k<SIMD_WIDTH;k++) if(finishBits>>k & 1) a->timer[i+k]=rng_range(&a->rng[i+k],4,8);
+
+        // continuous spin: dq = axis_angle(Y,yaw) * axis_angle(X,pitch), expanded
+        vf sy,cy,sx,cx;
+        vf_sincos(vf_mul(vf_mul(vf_load(a->spinY+i), spinScale), halfRadPerDeg), &sy, &cy);
+        vf_sincos(vf_mul(vf_mul(vf_load(a->spinX+i), spinScale), halfRadPerDeg), &sx, &cx);
+        vquat dq={ vf_mul(cy,sx), vf_mul(sy,cx), vf_neg(vf_mul(sy,sx)), vf_mul(cy,cx) };
+        o=vq_mul(dq, o);
+        vf_store(a->ox+i, o.x); vf_store(a->oy+i, o.y); vf_store(a->oz+i, o.z); vf_store(a->ow+i, o.w);
+    }
+}
+
+// --- Analytic model: orientation(t) = spin(t) * key(t), no per-frame state ---
+// Time is cut into segments of `period` seconds. Segment k holds keyframe k for period-dur
+// seconds, then slerps to keyframe k+1 over dur. Spin matches the integrated model: a constant
+// world-frame rate about (spinX, spinY, 0), at half speed while slerping. Keyframe 0 is the identity; keyframe k>0 is a
+// random Euler pose from its own RNG stream, so any k can be drawn without drawing 0..k-1.
+static quat anim_key(const ShapeAnim* a, int i, long long k){
+    if(k<=0) return q_ident();
+    uint64_t x=(uint64_t)k; Rng r=rng_seed(a->seed ^ splitmix64(&x), (uint64_t)a->id[i]);
+    float ex=rng_range(&r,-1,1), ey=rng_range(&r,-1,1), ez=rng_range(&r,-1,1);
+    return q_from_euler(ex, ey, ez);
+}
+
+static void anim_seg_prepare(KeySeg* s, long long k, quat qa, quat qb){
+    float dot=qa.x*qb.x + qa.y*qb.y + qa.z*qb.z + qa.w*qb.w;
+    if(dot<0){ qb.x=-qb.x; qb.y=-qb.y; qb.z=-qb.z; qb.w=-qb.w; dot=-dot; }
+    s->k=k; s->qa=qa; s->qb=qb; s->dot=dot;
+    if(dot>0.9995f){ s->th=0.0f; s->invSin=0.0f; }
+    else { s->th=trig_acos(dot); s->invSin=1.0f/sqrtf((1-dot)*(1+dot)); }
+}
+
+// Orientation of shape i at absolute time t (seconds). Only a->seg[i] is written, as a cache
+// of the segment's slerp constants, so disjoint ranges of shapes can be evaluated in parallel.
+static quat anim_eval(const ShapeAnim* a, int i, double t){
+    double P=a->period[i], dur=a->dur[i];
+    long long k=(long long)floor(t/P); double local=t-(double)k*P;
+    KeySeg* s=&a->seg[i];
+    if(s->k!=k) anim_seg_prepare(s, k, anim_key(a,i,k), anim_key(a,i,k+1));
+    quat key=s->qa;
+    if(local>P-dur){
+        float u=(float)((local-(P-dur))/dur);
+        if(s->invSin==0.0f){ quat r={ s->qa.x+u*(s->qb.x-s->qa.x), s->qa.y+u*(s->qb.y-s->qa.y), s->qa.z+u*(s->qb.z-s->qa.z), s->qa.w+u*(s->qb.w-s->qa.w) }; key=q_norm(r); }
+        else {
+            float su,cu; trig_sincos(u*s->th, &su, &cu);
+            float wb=su*s->invSin, wa=cu-s->dot*wb;
+            quat r={ wa*s->qa.x+wb*s->qb.x, wa*s->qa.y+wb*s->qb.y, wa*s->qa.z+wb*s->qb.z, wa*s->qa.w+wb*s->qb.w }; key=r;
+        }
+    }
+    // spin: angle = rate * spun time (slerps count half), reduced in double so long runs keep
+    // full float precision
+    double spun=t-0.5*((double)k*dur + (local>P-dur? local-(P-dur) : 0.0));
+    double wx=a->spinX[i], wy=a->spinY[i], w=sqrt(wx*wx+wy*wy);
+    if(w==0.0) return key;
+    float ang=(float)(fmod(w*spun, 360.0)*M_PI/180.0);
+    quat spin=q_from_axis_angle(v3((float)wx, (float)wy, 0.0f), ang); // normalises the axis
+    return q_mul(spin, key);
+}
+
+// Keeps the current orientation as the interpolation start before the next sim step.
+static void anim_snapshot(ShapeAnim* a, int begin, int end){
+    size_t n=sizeof(float)*(size_t)(end-begin);
+    memcpy(a->px+begin, a->ox+begin, n); memcpy(a->py+begin, a->oy+begin, n);
+    memcpy(a->pz+begin, a->oz+begin, n); memcpy(a->pw+begin, a->ow+begin, n);
+}
+
+// Job-pool adapter: runs this frame's `steps` fixed sim steps for one chunk. Shapes are
+// independent, so a chunk can take all of its steps without a barrier in between. Chunks are
+// SIMD_WIDTH-aligned because job_grain() rounds to a multiple of 8.
+typedef struct { ShapeAnim* anim; float h; int steps; } UpdateJob;
+static void update_shapes_job(void* ctx, int begin, int end){
+    UpdateJob* u=(UpdateJob*)ctx;
+    for(int s=0;s<u->steps;s++){
+        if(s==u->steps-1) anim_snapshot(u->anim, begin, end);
+        update_shapes(u->anim, begin, end, u->h);
+    }
+}
+
+// --------------------------- Hot reload ---------------------------
+// While running, the INI is watched (inotify on Linux, a once-a-second mtime check elsewhere).
+// On change it is re-parsed and diffed against the live ShapeConfig list: shapes whose line is
+// unchanged keep their geometry and animation, shapes whose line changed in anything but the
+// shape kind keep their animation too, and only the remainder is created or dropped. Windows
+// are untouched.
+
+// Everything a reload replaces; one arena per generation, so the old one is freed in one step.
+// runtime[i] and anim lane i belong to list.items[i].
+struct ShapeSet {
+    Arena arena;
+    ShapeList list;
+    ShapeRuntime* runtime; ShapeAnim anim; int count;
+    uint32_t nextId; // animation stream of the next added shape
+};
+
+static void runtime_apply_config(ShapeRuntime* R, const ShapeConfig* sc, vec3 pos){
+    R->shape=sc->shape; R->color=sc->color; R->worldPos=pos;
+    R->lod=sc->lod; R->glow=sc->glow; R->width=sc->width; R->scale=sc->scale;
+}
+
+static int shapeset_alloc(ShapeSet* s, int count){
+    s->runtime=(ShapeRuntime*)arena_calloc(&s->arena, count, sizeof(ShapeRuntime), 16);
+    return s->runtime && anim_init(&s->anim, count, &s->arena);
+}
+
+typedef struct { const char* path; const char* name; int fd; long long mtime; double nextPoll; } IniWatch;
+
+static long long file_mtime(const char* path){ struct stat st; return stat(path,&st)==0? (long long)st.st_mtime : -1; }
+
+static void ini_watch_open(IniWatch* w, const char* path){
+    memset(w,0,sizeof(*w)); w->path=path; w->fd=-1; w->mtime=file_mtime(path);
+    const char* slash=strrchr(path,'/');
+#ifdef _WIN32
+    const char* bs=strrchr(path,'\\'); if(bs && (!slash || bs>slash)) slash=bs;
+#endif
+    w->name=slash? slash+1 : path;
+#ifdef __linux__
+    // watch the directory: editors usually save by writing a new file and renaming it over
+    char dir[4096]; size_t n=slash? (size_t)(slash-path) : 0;
+    if(!slash) strcpy(dir,"."); else if(n==0) strcpy(dir,"/"); else if(n<sizeof(dir)){ memcpy(dir,path,n); dir[n]=0; } else return;
+    w->fd=inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+    if(w->fd>=0 && inotify_add_watch(w->fd, dir, IN_CLOSE_WRITE|IN_MOVED_TO)<0){ close(w->fd); w->fd=-1; }
+#endif
+}
+
+// Non-blocking; called once per frame.
+static int ini_watch_changed(IniWatch* w, double now){
+#ifdef __linux__
+    if(w->fd>=0){
+        _Alignas(struct inotify_event) char buf[4096]; ssize_t n; int hit=0;
+        while((n=read(w->fd, buf, sizeof(buf)))>0)
+            for(char* p=buf; p<buf+n; ){ const struct inotify_event* e=(const struct inotify_event*)p; if(e->len && strcmp(e->name, w->name)==0) hit=1; p+=sizeof(*e)+e->len; }
+        return hit;
+    }
+#endif
+    if(now<w->nextPoll) return 0;
+    w->nextPoll=now+1.0;
+    long long m=file_mtime(w->path); if(m==w->mtime) return 0;
+    w->mtime=m; return m>=0;
+}
+
+static void ini_watch_close(IniWatch* w){
+#ifdef __linux__
+    if(w->fd>=0) close(w->fd);
+#endif
+    w->fd=-1;
+}
+
+// Field-wise, so padding never takes part; equal configs always share a key.
+static uint64_t shape_key(ShapeConfig c){
+    int32_t i[6]={ c.shape, c.color, c.pos, c.screen, c.lod, c.glow }; float f[3]={ c.width, c.spin, c.scale };
+    return fnv1a64(fnv1a64(FNV1A_INIT, i, sizeof(i)), f, sizeof(f));
+}
+static int shape_config_eq(const ShapeConfig* a, const ShapeConfig* b){
+    return a->shape==b->shape && a->color==b->color && a->pos==b->pos && a->screen==b->screen && a->lod==b->lod && a->glow==b->glow
+        && a->width==b->width && a->spin==b->spin && a->scale==b->scale;
+}
+
+// Rebuilds `cur` for the config in nx.list (allocated from nx.arena, which this takes over),
+// reusing state wherever the diff allows; also re-binds shapes to the current windows.
+// placedFor > 0 is the screen count cur's positions were resolved for: an unchanged shape that
+// still lands on the same screen then keeps its position instead of being laid out again.
+// Returns 1 when the arrays were replaced (0: same order, positions/windows refreshed in place).
+static int shapes_update(ShapeSet* cur, ShapeSet nx, ScreenSet* scr, uint64_t seed, Arena* meshes, const char* what, int placedFor){
+    uint64_t t0=time_now_us();
+    nx.count=nx.list.count; nx.nextId=cur->nextId;
+    if(!sort_by_window(&nx.list, scr, &nx.arena)){ fprintf(stderr,"[ornament] %s: out of memory\n", what); arena_free(&nx.arena); return 0; }
+    int n=nx.count, o=cur->count;
+    int hsize=16; while(hsize<2*o) hsize<<=1;
+    uint64_t* bk=(uint64_t*)arena_alloc(&nx.arena, sizeof(uint64_t)*(size_t)hsize, 8);
+    int* bh=(int*)arena_alloc(&nx.arena, sizeof(int)*(size_t)hsize, 8);   // first free old index of the key; -2 = empty slot
+    int* next=(int*)arena_alloc(&nx.arena, sizeof(int)*(size_t)(o+1), 8);
+    int* src=(int*)arena_alloc(&nx.arena, sizeof(int)*(size_t)(n+1), 8);  // old index feeding new shape j, -1 = added
+    char* used=(char*)arena_calloc(&nx.arena, (size_t)o+1, 1, 8);
+    vec3* pos=(vec3*)arena_alloc(&nx.arena, sizeof(vec3)*(size_t)n, 16);
+    if(!bk || !bh || !next || !src || !used || !pos || !shapeset_alloc(&nx, n)){ fprintf(stderr,"[ornament] %s: out of memory\n", what); arena_free(&nx.arena); return 0; }
+
+    // 1) identical lines, matched in file order: open-addressed key -> list of old indices
+    for(int i=0;i<hsize;i++) bh[i]=-2;
+    #define KEY_SLOT(k, slot) do{ uint64_t x_=(k); slot=(int)(splitmix64(&x_)&(uint64_t)(hsize-1)); while(bh[slot]!=-2 && bk[slot]!=(k)) slot=(slot+1)&(hsize-1); }while(0)
+    for(int i=o-1;i>=0;i--){
+        uint64_t k=shape_key(cur->list.items[i]); int slot; KEY_SLOT(k, slot);
+        if(bh[slot]==-2){ bk[slot]=k; bh[slot]=-1; }
+        next[i]=bh[slot]; bh[slot]=i;
+    }
+    int kept=0, updated=0, added=0;
+    for(int j=0;j<n;j++){
+        uint64_t k=shape_key(nx.list.items[j]); int slot; KEY_SLOT(k, slot);
+        src[j]=-1;
+        if(bh[slot]>=0 && shape_config_eq(&cur->list.items[bh[slot]], &nx.list.items[j])){ int i=bh[slot]; bh[slot]=next[i]; src[j]=i; used[i]=1; kept++; }
+    }
+    #undef KEY_SLOT
+    // 2) remaining lines pair up with leftover shapes of the same kind (animation carries over)
+    int kindHead[SH_COUNT]; for(int k=0;k<SH_COUNT;k++) kindHead[k]=-1;
+    for(int i=o-1;i>=0;i--) if(!used[i]){ int k=cur->list.items[i].shape; next[i]=kindHead[k]; kindHead[k]=i; }
+    for(int j=0;j<n;j++) if(src[j]<0){
+        int k=nx.list.items[j].shape;
+        if(kindHead[k]>=0){ int i=kindHead[k]; kindHead[k]=next[i]; src[j]=i; used[i]=1; updated++; }
+        else added++;
+    }
+    int removed=o-kept-updated, moved=0;
+    for(int j=0;j<n;j++) if(src[j]!=j) moved=1;
+    place_shapes(&nx.list, scr->monCount, pos, NULL);
+    #define KEEP_POS(j) (placedFor>0 && src[j]>=0 && shape_config_eq(&cur->list.items[src[j]], &nx.list.items[j]) \
+        && CLAMP(nx.list.items[j].screen,0,placedFor-1)==CLAMP(nx.list.items[j].screen,0,scr->monCount-1))
+    for(int j=0;j<n;j++) if(KEEP_POS(j)) pos[j]=cur->runtime[src[j]].worldPos;
+    #undef KEEP_POS
+    if(!updated && !added && !removed && !moved){
+        // same shapes in the same order; the screen layout may still have changed
+        for(int i=0;i<o;i++){ cur->runtime[i].worldPos=pos[i]; cur->runtime[i].window=screen_window(scr, cur->list.items[i].screen); }
+        bind_windows(scr, cur->runtime, cur->count);
+        arena_free(&nx.arena); return 0;
+    }
+
+    // 3) build the new generation; meshes are immutable, so one per kind and LOD is shared
+    WireGeom mesh[SH_COUNT][MESH_LODS]; memset(mesh,0,sizeof(mesh));
+    for(int i=0;i<o;i++){ const ShapeRuntime* r=&cur->runtime[i]; if(!mesh[r->shape][r->lod].verts) mesh[r->shape][r->lod]=r->geom; }
+    for(int j=0;j<n;j++){
+        const ShapeConfig* sc=&nx.list.items[j]; ShapeRuntime R={0};
+        WireGeom* m=&mesh[sc->shape][sc->lod];
+        if(!m->verts) *m=make_shape_geom(meshes, sc->shape, sc->lod);
+        if(src[j]>=0){
+            const ShapeConfig* old=&cur->list.items[src[j]];
+            R=cur->runtime[src[j]]; anim_move(&nx.anim, j, &cur->anim, src[j]);
+            if(old->spin!=sc->spin) anim_scale_spin(&nx.anim, j, sc->spin/old->spin);
+        } else { anim_spawn_id(&nx.anim, j, seed, nx.nextId++); anim_scale_spin(&nx.anim, j, sc->spin); }
+        runtime_apply_config(&R, sc, pos[j]);
+        R.geom=*m; R.window=screen_window(scr, sc->screen);
+        nx.runtime[j]=R;
+    }
+    arena_free(&cur->arena);
+    *cur=nx;
+    bind_windows(scr, cur->runtime, cur->count);
+    fprintf(stderr,"[ornament] %s: %d kept, %d updated, %d added, %d removed (%.2f ms)\n", what, kept, updated, added, removed, (double)(time_now_us()-t0)/1000.0);
+    return 1;
+}
+
+// Re-reads `path` and diffs it into `cur`.
+static int shapes_reload(ShapeSet* cur, const char* path, ScreenSet* scr, uint64_t seed, Arena* meshes){
+    if(file_mtime(path)<0) return 0; // mid-rename or deleted: keep what is running
+    ShapeSet nx={0};
+    nx.list=load_ini(path, &nx.arena);
+    char what[600]; snprintf(what, sizeof(what), "reloaded %s", path);
+    return shapes_update(cur, nx, scr, seed, meshes, what, 0);
+}
+
+// Same config, new screen layout (monitor hotplug): shapes move to their windows' runs and keep
+// their positions (laid out or loaded from --scene) unless they fold onto a different screen.
+static int shapes_rebind(ShapeSet* cur, ScreenSet* scr, int placedFor, uint64_t seed, Arena* meshes){
+    ShapeSet nx={0};
+    nx.list.count=cur->list.count;
+    nx.list.items=(ShapeConfig*)arena_alloc(&nx.arena, sizeof(ShapeConfig)*(size_t)(cur->list.count+1), 8);
+    if(!nx.list.items){ arena_free(&nx.arena); return 0; }
+    memcpy(nx.list.items, cur->list.items, sizeof(ShapeConfig)*(size_t)cur->list.count);
+    return shapes_update(cur, nx, scr, seed, meshes, "rebound shapes to screens", placedFor);
+}
+
+// --------------------------- Monitors (hotplug) ---------------------------
+// Windows are created sharing one hidden context made at startup. Rendering is immediate mode
+// and the per-window objects (overdraw, timer queries) live in their own window's context, so
+// nothing is actually shared today; the hidden context is what is made current while a window
+// that was current is destroyed. Without it hotplug is disabled. The GLFW callback only raises
+// a flag; windows are reconciled on the main thread after glfwPollEvents.
+static GLFWwindow* g_shareCtx;
+static atomic_int g_monitorsChanged;
+static void on_monitor_event(GLFWmonitor* m, int event){ (void)m; (void)event; atomic_store(&g_monitorsChanged, 1); }
+
+static int create_screen_window(ScreenWindow* sw, GLFWmonitor* mon, int monIndex, int vsync){
+    const GLFWvidmode* vm = glfwGetVideoMode(mon); if(!vm) return 0;
+    GLFWwindow* w = glfwCreateWindow(vm->width, vm->height, "Ornament", NULL, g_shareCtx);
+    if(!w) return 0;
+    memset(sw,0,sizeof(*sw)); sw->monIndex=monIndex;
+    // position window at monitor origin
+    int mx,my; glfwGetMonitorPos(mon, &mx, &my); glfwSetWindowPos(w, mx, my);
+    glfwMakeContextCurrent(w);
+    glfwSwapInterval(vsync?1:0);
+    sw->win=w; sw->monitor=mon; sw->width=vm->width; sw->height=vm->height; sw->refreshHz=vm->refreshRate; float xs=1,ys=1; glfwGetWindowContentScale(w,&xs,&ys); sw->contentScale.x=xs; sw->contentScale.y=ys;
+    sw->cam = make_camera(sw->width, sw->height);
+    return 1;
+}
+
+// Matches windows to the monitors connected now: a window whose monitor is still needed is
+// kept (only its index may change), newly needed monitors get a window, the rest are closed,
+// then shapes are re-bound. Returns 1 when the shape arrays were replaced.
+static int screens_sync(ScreenSet* scr, ShapeSet* shapes, const Options* opt, Arena* meshes){
+    uint64_t t0=time_now_us();
+    int n=0; GLFWmonitor** mons=glfwGetMonitors(&n);
+    if(n<=0) return 0; // everything unplugged: keep the windows until a monitor comes back
+    char* need=(char*)calloc((size_t)n+(size_t)scr->count, 1); // need[n], then kept[count]
+    ScreenWindow* arr=(ScreenWindow*)calloc((size_t)n, sizeof(ScreenWindow));
+    if(!need || !arr){ free(need); free(arr); return 0; }
+    char* kept=need+n;
+    int any=0;
+    for(int i=0;i<shapes->list.count;i++){ int m=CLAMP(shapes->list.items[i].screen,0,n-1); need[m]=1; any=1; }
+    if(!any) need[0]=1;
+    int wc=0, opened=0, closed=0;
+    for(int m=0;m<n;m++) if(need[m]){
+        int w=-1; for(int k=0;k<scr->count;k++) if(!kept[k] && scr->arr[k].monitor==mons[m]){ w=k; break; }
+        if(w>=0){ kept[w]=1; arr[wc]=scr->arr[w]; arr[wc++].monIndex=m; }
+        else if(create_screen_window(&arr[wc], mons[m], m, opt->vsync)){ wc++; opened++; }
+        else fprintf(stderr,"Failed to create window for monitor %d\n", m);
     }
+    if(wc==0){ free(need); free(arr); return 0; }
+    for(int k=0;k<scr->count;k++) if(!kept[k] && scr->arr[k].win){
+        if(scr->arr[k].od || scr->arr[k].tm){ glfwMakeContextCurrent(scr->arr[k].win); overdraw_release(&scr->arr[k], k); telemetry_window_release(&scr->arr[k]); }
+        if(glfwGetCurrentContext()==scr->arr[k].win) glfwMakeContextCurrent(g_shareCtx);
+        glfwDestroyWindow(scr->arr[k].win); closed++;
+    }
+    free(need); free(scr->arr);
+    int placedFor=scr->monCount;
+    scr->arr=arr; scr->count=wc; scr->monCount=n;
+    int replaced=shapes_rebind(shapes, scr, placedFor, opt->seed, meshes);
+    fprintf(stderr,"[ornament] monitors changed: %d connected, %d windows opened, %d closed (%.2f ms)\n", n, opened, closed, (double)(time_now_us()-t0)/1000.0);
+    return replaced;
+}
 
-    ShapeList list = load_ini(iniPath);
+// --------------------------- Control socket ---------------------------
+// A running ornament listens on a Unix-domain socket ($XDG_RUNTIME_DIR/ornament.sock, or
+// --control PATH) for one-line text commands and answers each with one line, "ok ..." or
+// "err ...":
+//   pause | resume | fps N | brightness X | thickness X | reload | stats
+// e.g.  echo stats | socat - UNIX-CONNECT:$XDG_RUNTIME_DIR/ornament.sock
+// A control thread owns the sockets and sleeps in poll(). Parsed commands reach the render
+// thread through a lock-free single-producer/single-consumer ring that app_loop drains at the
+// top of each frame; replies go back through a second ring plus a wake-up pipe. Rendering never
+// waits on a client: when a ring is full the command is refused ("err busy").
+#define CTL_RING_CAP 64    // messages per ring; power of two
+#define CTL_TEXT_MAX 512   // longest request or reply line
+#define CTL_MAX_CLIENTS 8
+
+typedef enum { CTL_PAUSE, CTL_RESUME, CTL_FPS, CTL_BRIGHTNESS, CTL_THICKNESS, CTL_RELOAD, CTL_STATS } CtlOp;
+typedef struct { CtlOp op; uint32_t client; float value; char text[CTL_TEXT_MAX]; } CtlMsg; // text: replies only
+
+// tail is written only by the producer, head only by the consumer; each on its own cache line.
+typedef struct { _Alignas(64) atomic_uint head; _Alignas(64) atomic_uint tail; CtlMsg msg[CTL_RING_CAP]; } CtlRing;
+
+static int ctl_ring_push(CtlRing* r, const CtlMsg* m){
+    unsigned t=atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if(t-atomic_load_explicit(&r->head, memory_order_acquire)>=CTL_RING_CAP) return 0;
+    r->msg[t&(CTL_RING_CAP-1)]=*m;
+    atomic_store_explicit(&r->tail, t+1, memory_order_release);
+    return 1;
+}
+static int ctl_ring_pop(CtlRing* r, CtlMsg* m){
+    unsigned h=atomic_load_explicit(&r->head, memory_order_relaxed);
+    if(h==atomic_load_explicit(&r->tail, memory_order_acquire)) return 0;
+    *m=r->msg[h&(CTL_RING_CAP-1)];
+    atomic_store_explicit(&r->head, h+1, memory_order_release);
+    return 1;
+}
 
-    if(!glfwInit()){ fprintf(stderr,"Failed to init GLFW\n"); return 1; }
+typedef struct {
+    CtlRing commands; // control thread -> render thread
+    CtlRing replies;  // render thread -> control thread
+    int listenFd, wake[2]; // wake: written after each reply and at shutdown
+    char path[108];
+    Thread thread; atomic_int quit;
+    struct { int fd; uint32_t id; int len; char buf[CTL_TEXT_MAX]; } client[CTL_MAX_CLIENTS];
+    uint32_t nextId; // client ids are never reused, so a late reply cannot reach a new client
+} Control;
+
+#ifdef ORNAMENT_HAS_CONTROL
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // macOS: SO_NOSIGPIPE is set per socket instead
+#endif
 
-    int monCount=0; GLFWmonitor** mons = glfwGetMonitors(&monCount);
-    if(monCount<=0){ fprintf(stderr,"No monitors found\n"); glfwTerminate(); return 1; }
+static void set_nonblocking(int fd){ fcntl(fd, F_SETFL, fcntl(fd, F_GETFL)|O_NONBLOCK); fcntl(fd, F_SETFD, FD_CLOEXEC); }
+
+static void control_drop(Control* c, int k){ close(c->client[k].fd); c->client[k].fd=-1; c->client[k].len=0; }
+
+// Control thread only. Replies are short; a client that cannot take one is dropped.
+static void control_send(Control* c, uint32_t id, const char* text){
+    for(int k=0;k<CTL_MAX_CLIENTS;k++) if(c->client[k].fd>=0 && c->client[k].id==id){
+        size_t n=strlen(text);
+        if(send(c->client[k].fd, text, n, MSG_DONTWAIT|MSG_NOSIGNAL)!=(ssize_t)n) control_drop(c, k);
+        return;
+    }
+}
+
+// Parses one request line on the control thread; malformed ones are answered right here.
+static void control_request(Control* c, int k, char* line){
+    char word[16]=""; float v=0; CtlMsg m; memset(&m, 0, sizeof(m)); m.client=c->client[k].id;
+    int n=sscanf(line, "%15s %f", word, &v);
+    if(n<1) return; // blank line
+    if(strcmp(word,"pause")==0) m.op=CTL_PAUSE;
+    else if(strcmp(word,"resume")==0) m.op=CTL_RESUME;
+    else if(strcmp(word,"reload")==0) m.op=CTL_RELOAD;
+    else if(strcmp(word,"stats")==0) m.op=CTL_STATS;
+    else if(strcmp(word,"fps")==0 && n==2 && v>=0 && v<=1000) m.op=CTL_FPS;
+    else if(strcmp(word,"brightness")==0 && n==2 && v>0 && v<=16) m.op=CTL_BRIGHTNESS;
+    else if(strcmp(word,"thickness")==0 && n==2 && v>0 && v<=64) m.op=CTL_THICKNESS;
+    else { control_send(c, m.client, "err usage: pause | resume | fps N (0-1000, 0 = uncapped) | brightness X (0-16] | thickness X (0-64] | reload | stats\n"); return; }
+    m.value=v;
+    if(!ctl_ring_push(&c->commands, &m)) control_send(c, m.client, "err busy\n");
+}
+
+static void control_main(void* arg){
+    Control* c=(Control*)arg;
+    trace_thread_name("control");
+    while(!atomic_load(&c->quit)){
+        struct pollfd pfd[2+CTL_MAX_CLIENTS]; int slot[2+CTL_MAX_CLIENTS], n=0;
+        pfd[n].fd=c->wake[0]; pfd[n].events=POLLIN; slot[n++]=-1;
+        pfd[n].fd=c->listenFd; pfd[n].events=POLLIN; slot[n++]=-1;
+        for(int k=0;k<CTL_MAX_CLIENTS;k++) if(c->client[k].fd>=0){ pfd[n].fd=c->client[k].fd; pfd[n].events=POLLIN; slot[n++]=k; }
+        for(int i=0;i<n;i++) pfd[i].revents=0;
+        if(poll(pfd, (nfds_t)n, -1)<0 && errno!=EINTR) break;
+        if(pfd[0].revents){ char b[64]; while(read(c->wake[0], b, sizeof(b))>0){} }
+        CtlMsg m; while(ctl_ring_pop(&c->replies, &m)) control_send(c, m.client, m.text);
+        if(pfd[1].revents & POLLIN){
+            int fd;
+            while((fd=accept(c->listenFd, NULL, NULL))>=0){
+                int k=0; while(k<CTL_MAX_CLIENTS && c->client[k].fd>=0) k++;
+                if(k==CTL_MAX_CLIENTS){ (void)!send(fd, "err too many clients\n", 21, MSG_DONTWAIT|MSG_NOSIGNAL); close(fd); continue; }
+                set_nonblocking(fd);
+#ifdef SO_NOSIGPIPE
+                int one=1; setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+                c->client[k].fd=fd; c->client[k].id=++c->nextId; c->client[k].len=0;
+            }
+        }
+        for(int i=2;i<n;i++){
+            int k=slot[i]; if(!pfd[i].revents || c->client[k].fd<0) continue;
+            ssize_t r=read(c->client[k].fd, c->client[k].buf+c->client[k].len, (size_t)(CTL_TEXT_MAX-1-c->client[k].len));
+            if(r==0 || (r<0 && errno!=EAGAIN && errno!=EINTR)){ control_drop(c, k); continue; }
+            if(r<0) continue;
+            c->client[k].len+=(int)r; c->client[k].buf[c->client[k].len]=0;
+            char* line=c->client[k].buf; char* nl;
+            while(c->client[k].fd>=0 && (nl=strchr(line,'\n'))!=NULL){ *nl=0; control_request(c, k, line); line=nl+1; }
+            if(c->client[k].fd<0) continue;
+            int rest=c->client[k].len-(int)(line-c->client[k].buf);
+            if(rest>=CTL_TEXT_MAX-1){ control_send(c, c->client[k].id, "err line too long\n"); control_drop(c, k); continue; }
+            memmove(c->client[k].buf, line, (size_t)rest); c->client[k].len=rest;
+        }
+    }
+    for(int k=0;k<CTL_MAX_CLIENTS;k++) if(c->client[k].fd>=0) control_drop(c, k);
+}
+
+// Binds `path` (replacing a stale socket left by a crashed run) and starts the control thread.
+// Returns NULL, with a warning, when the socket cannot be served.
+static Control* control_open(const char* path){
+    struct sockaddr_un sa; memset(&sa, 0, sizeof(sa)); sa.sun_family=AF_UNIX;
+    if(strlen(path)>=sizeof(sa.sun_path)){ fprintf(stderr,"warn: control socket path too long: %s\n", path); return NULL; }
+    strcpy(sa.sun_path, path);
+    int fd=socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd<0){ fprintf(stderr,"warn: control socket: %s\n", strerror(errno)); return NULL; }
+    int bound=bind(fd, (struct sockaddr*)&sa, sizeof(sa))==0;
+    if(!bound && errno==EADDRINUSE){
+        int probe=socket(AF_UNIX, SOCK_STREAM, 0), live=probe>=0 && connect(probe, (struct sockaddr*)&sa, sizeof(sa))==0;
+        if(probe>=0) close(probe);
+        if(live){ fprintf(stderr,"warn: another ornament is serving %s; control socket disabled\n", path); close(fd); return NULL; }
+        unlink(path);
+        bound=bind(fd, (struct sockaddr*)&sa, sizeof(sa))==0;
+    }
+    if(!bound){ fprintf(stderr,"warn: control socket %s: %s\n", path, strerror(errno)); close(fd); return NULL; }
+    chmod(path, 0600);
+    Control* c=(Control*)calloc(1, sizeof(Control));
+    if(!c || listen(fd, 4)<0 || pipe(c->wake)<0){ fprintf(stderr,"warn: control socket %s: %s\n", path, strerror(errno)); close(fd); unlink(path); free(c); return NULL; }
+    set_nonblocking(fd); set_nonblocking(c->wake[0]); set_nonblocking(c->wake[1]);
+    c->listenFd=fd; snprintf(c->path, sizeof(c->path), "%s", path);
+    for(int k=0;k<CTL_MAX_CLIENTS;k++) c->client[k].fd=-1;
+    atomic_init(&c->commands.head, 0); atomic_init(&c->commands.tail, 0); atomic_init(&c->replies.head, 0); atomic_init(&c->replies.tail, 0); atomic_init(&c->quit, 0);
+    if(!thread_start(&c->thread, control_main, c)){ close(fd); close(c->wake[0]); close(c->wake[1]); unlink(path); free(c); return NULL; }
+    fprintf(stderr,"[ornament] control socket: %s\n", path);
+    return c;
+}
+
+static void control_close(Control* c){
+    if(!c) return;
+    atomic_store(&c->quit, 1); (void)!write(c->wake[1], "q", 1);
+    thread_join(c->thread);
+    close(c->listenFd); close(c->wake[0]); close(c->wake[1]); unlink(c->path);
+    free(c);
+}
+
+// Render thread: queues a reply line for the control thread to send.
+static void control_reply(Control* c, uint32_t client, const char* fmt, ...){
+    CtlMsg m; memset(&m, 0, sizeof(m)); m.client=client;
+    va_list ap; va_start(ap, fmt); int n=vsnprintf(m.text, sizeof(m.text)-1, fmt, ap); va_end(ap);
+    n=CLAMP(n, 0, (int)sizeof(m.text)-2);
+    m.text[n]='\n'; m.text[n+1]=0;
+    if(ctl_ring_push(&c->replies, &m)) (void)!write(c->wake[1], "r", 1); // full ring: the reply is lost, the command still ran
+}
+#else
+static Control* control_open(const char* path){ fprintf(stderr,"warn: --control needs Unix-domain sockets; ignored (%s)\n", path); return NULL; }
+static void control_close(Control* c){ (void)c; }
+static void control_reply(Control* c, uint32_t client, const char* fmt, ...){ (void)c; (void)client; (void)fmt; }
+#endif
+
+// Render thread, top of each frame: applies every queued command. Returns 1 when a reload
+// replaced the shape arrays, so the caller rebuilds its draw lists.
+static int control_frame(Control* c, Options* opt, ShapeSet* shapes, ScreenSet* scr, Arena* meshes, const FrameStats* st, double startSec, int* paused){
+    CtlMsg m; int replaced=0;
+    while(ctl_ring_pop(&c->commands, &m)){
+        switch(m.op){
+        case CTL_PAUSE: *paused=1; control_reply(c, m.client, "ok paused"); break;
+        case CTL_RESUME: *paused=0; control_reply(c, m.client, "ok resumed"); break;
+        case CTL_FPS: opt->fpsCap=(int)m.value; control_reply(c, m.client, "ok fps %d", opt->fpsCap); break;
+        case CTL_BRIGHTNESS: opt->brightness=m.value; control_reply(c, m.client, "ok brightness %.3f", opt->brightness); break;
+        case CTL_THICKNESS: opt->thickness=m.value; control_reply(c, m.client, "ok thickness %.3f", opt->thickness); break;
+        case CTL_RELOAD:
+            if(opt->scenePath || opt->recordPath || opt->replayPath){ control_reply(c, m.client, "err reload is unavailable with --scene/--record/--replay"); break; }
+            if(shapes_reload(shapes, opt->iniPath, scr, opt->seed, meshes)) replaced=1;
+            control_reply(c, m.client, "ok reloaded %s: %d shapes", opt->iniPath, shapes->count);
+            break;
+        case CTL_STATS: {
+            double n=st->frames>0? (double)st->frames : 1.0, wall=(double)time_now_us()*1e-6-startSec;
+            control_reply(c, m.client, "ok {\"frames\":%d,\"fps\":%.3f,\"update_ms\":%.6f,\"draw_ms\":%.6f,\"present_ms\":%.6f,\"edges_per_frame\":%.1f,\"shapes\":%d,\"screens\":%d,\"paused\":%d,\"fps_cap\":%d,\"brightness\":%.3f,\"thickness\":%.3f}",
+                          st->frames, wall>0? st->frames/wall : 0.0, st->updateUs/n/1000.0, st->drawUs/n/1000.0, st->presentUs/n/1000.0, (double)st->edges/n,
+                          shapes->count, scr->count, *paused, opt->fpsCap, opt->brightness, opt->thickness);
+            break; }
+        }
+    }
+    return replaced;
+}
+
+// --------------------------- Telemetry (shared memory) ---------------------------
+// --telemetry NAME publishes a TelemetryBlock in POSIX shared memory (shm_open(NAME), e.g.
+// /dev/shm/ornament on Linux), rewritten at the end of every frame. The render side makes no
+// syscalls and takes no locks for it: the block is guarded by a sequence lock. seq is odd while
+// the writer is inside; a reader copies the block and keeps the copy only if seq was even and
+// unchanged across the copy:
+//   do { s1=load_acquire(&b->seq); copy=*b; fence_acquire(); s2=load_relaxed(&b->seq); } while(s1&1 || s1!=s2);
+// --read-telemetry NAME does exactly that and prints the snapshot as JSON. Readers must check
+// magic, version and size; fields are only ever appended, with the version bumped.
+// Without a NAME the block lives in private memory, read only by the --metrics-file exporter.
+// Frame-time percentiles cover each window's last TELEMETRY_HISTORY frames (draw + present
+// CPU time), kept sorted as they arrive so publishing is a lookup. GPU times come from
+// GL_TIME_ELAPSED queries read back TELEMETRY_QUERIES-1 frames later, never waited on; they
+// stay 0 where timer queries are missing. Both live with the window (query objects are not
+// shared between contexts) and go when it closes.
+#define TELEMETRY_MAGIC "ORNTELEM"
+#define TELEMETRY_VERSION 2 // 2: dropped frames and the frame-time histogram
+#define TELEMETRY_MAX_WINDOWS HEADLESS_MAX_SCREENS
+#define TELEMETRY_HISTORY 128 // power of two
+#define TELEMETRY_QUERIES 4   // timer queries in flight per window
+#define TELEMETRY_BUCKETS 9   // frame-time histogram: TELEMETRY_BUCKET_MS upper bounds, then +Inf
+static const double TELEMETRY_BUCKET_MS[TELEMETRY_BUCKETS-1] = { 4, 8, 16.7, 33.3, 50, 100, 250, 500 };
+
+typedef struct {
+    int32_t monIndex, width, height, shapes;
+    float frameMs[4]; // p50, p90, p99, max
+    float gpuMs[4];   // p50, p90, p99, max
+    uint64_t frames;
+    uint64_t reserved;
+} TelemetryWindow; // 64 bytes
+
+typedef struct {
+    char magic[8]; uint32_t version, size; // size: sizeof(TelemetryBlock) as written
+    int32_t pid, reserved0;
+    _Atomic uint64_t seq;
+    // covered by seq:
+    uint64_t frames, simSteps, edges;   // edges: line segments of the last frame
+    uint64_t publishUs;                 // monotonic clock (us) at the last update
+    double wallSec, simTime, fps;       // fps over the last TELEMETRY_HISTORY frames
+    float updateMs, reserved1;          // shape update + transforms, last frame
+    int32_t shapes, windows, paused, fpsCap;
+    uint64_t arenaBytes; int64_t peakRssKb; // peak RSS is refreshed every TELEMETRY_HISTORY frames
+    TelemetryWindow win[TELEMETRY_MAX_WINDOWS];
+    // version 2:
+    uint64_t droppedFrames;                     // frames that missed the budget, counted in missed intervals
+    uint64_t frameBucket[TELEMETRY_BUCKETS];    // frame intervals per histogram bucket (not cumulative)
+    double frameSecSum;                         // sum of all frame intervals
+    double budgetSec;                           // frame budget: 1/fps cap, else the slowest refresh with vsync; 0 = none
+} TelemetryBlock; // 128 + 64 x TELEMETRY_MAX_WINDOWS + 104 bytes
+
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+typedef void (*TqQueryFn)(GLenum);
+typedef void (*TqGetivFn)(GLuint, GLenum, GLint*);
+typedef void (*TqGetui64Fn)(GLuint, GLenum, uint64_t*);
+
+static struct { int gpu; HlGenFn genQueries; HlDeleteFn deleteQueries; HlBindFn beginQuery; TqQueryFn endQuery; TqGetivFn getQueryiv; TqGetui64Fn getQueryui64v; } g_tq;
+
+// The last TELEMETRY_HISTORY samples in arrival order (ring) and in ascending order (sorted).
+typedef struct { float ring[TELEMETRY_HISTORY], sorted[TELEMETRY_HISTORY]; int n; } TelemetrySeries;
+
+struct TelemetrySlot {
+    TelemetrySeries frameMs, gpuMs;
+    GLuint query[TELEMETRY_QUERIES]; int issued[TELEMETRY_QUERIES], qnext, gpuWarm;
+    uint64_t frames;
+};
+
+typedef struct {
+    TelemetryBlock* blk; char name[256]; // name[0]==0: private block (metrics only)
+    float frameSec[TELEMETRY_HISTORY]; int nFrames; uint64_t lastUs;
+    int64_t peakRssKb;
+    uint64_t dropped, bucket[TELEMETRY_BUCKETS]; double frameSecSum;
+} Telemetry;
+
+#ifdef ORNAMENT_HAS_TELEMETRY
+static int telemetry_name(char* out, size_t cap, const char* name){
+    int n=snprintf(out, cap, "%s%s", name[0]=='/'? "" : "/", name);
+    return n>1 && (size_t)n<cap && !strchr(out+1,'/');
+}
+
+// Maps shared-memory block `name` read-write, refusing one a live process is still publishing.
+static TelemetryBlock* telemetry_map(const char* name){
+    int fd=shm_open(name, O_RDWR|O_CREAT, 0600);
+    if(fd<0){ fprintf(stderr,"warn: --telemetry %s: %s\n", name, strerror(errno)); return NULL; }
+    struct stat sb;
+    if(fstat(fd,&sb)==0 && sb.st_size>=(off_t)sizeof(TelemetryBlock)){
+        const TelemetryBlock* old=(const TelemetryBlock*)mmap(NULL, sizeof(TelemetryBlock), PROT_READ, MAP_SHARED, fd, 0);
+        int live=old!=MAP_FAILED && memcmp(old->magic, TELEMETRY_MAGIC, 8)==0 && old->pid>0 && old->pid!=(int32_t)getpid() && kill(old->pid, 0)==0;
+        if(old!=MAP_FAILED) munmap((void*)old, sizeof(TelemetryBlock));
+        if(live){ fprintf(stderr,"warn: --telemetry %s is being published by another process; disabled\n", name); close(fd); return NULL; }
+    }
+    void* p=MAP_FAILED;
+    if(ftruncate(fd, (off_t)sizeof(TelemetryBlock))==0) p=mmap(NULL, sizeof(TelemetryBlock), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(p==MAP_FAILED){ fprintf(stderr,"warn: --telemetry %s: %s\n", name, strerror(errno)); shm_unlink(name); return NULL; }
+    return (TelemetryBlock*)p;
+}
+#endif
+
+// Seqlock read: copies a consistent snapshot of `b`. Returns 0 if the writer never settles.
+static int telemetry_snapshot(const TelemetryBlock* b, TelemetryBlock* out){
+    for(int tries=0; tries<1000000; tries++){
+        uint64_t s1=atomic_load_explicit(&b->seq, memory_order_acquire);
+        if(s1&1){ CPU_RELAX(); continue; }
+        memcpy(out, (const void*)b, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+        if(atomic_load_explicit(&b->seq, memory_order_relaxed)==s1) return 1;
+    }
+    return 0;
+}
+
+// shmName NULL: the block is private memory (for the --metrics-file exporter only).
+static Telemetry* telemetry_open(const char* shmName){
+    Telemetry* t=(Telemetry*)calloc(1, sizeof(Telemetry)); if(!t) return NULL;
+    if(shmName){
+#ifdef ORNAMENT_HAS_TELEMETRY
+        if(!telemetry_name(t->name, sizeof(t->name), shmName)) fprintf(stderr,"warn: bad --telemetry name '%s'\n", shmName);
+        else t->blk=telemetry_map(t->name);
+#else
+        fprintf(stderr,"warn: --telemetry needs POSIX shared memory; ignored (%s)\n", shmName);
+#endif
+    } else t->blk=(TelemetryBlock*)calloc(1, sizeof(TelemetryBlock));
+    if(!t->blk){ free(t); return NULL; }
+    memset(t->blk, 0, sizeof(TelemetryBlock));
+    memcpy(t->blk->magic, TELEMETRY_MAGIC, 8); t->blk->version=TELEMETRY_VERSION; t->blk->size=(uint32_t)sizeof(TelemetryBlock);
+#ifdef _WIN32
+    t->blk->pid=(int32_t)GetCurrentProcessId();
+#else
+    t->blk->pid=(int32_t)getpid();
+#endif
+    atomic_store_explicit(&t->blk->seq, 0, memory_order_release);
+    g_tq.genQueries=(HlGenFn)gl_proc("glGenQueries"); g_tq.deleteQueries=(HlDeleteFn)gl_proc("glDeleteQueries");
+    g_tq.beginQuery=(HlBindFn)gl_proc("glBeginQuery"); g_tq.endQuery=(TqQueryFn)gl_proc("glEndQuery");
+    g_tq.getQueryiv=(TqGetivFn)gl_proc("glGetQueryObjectiv"); g_tq.getQueryui64v=(TqGetui64Fn)gl_proc("glGetQueryObjectui64v");
+    g_tq.gpu=g_tq.genQueries && g_tq.deleteQueries && g_tq.beginQuery && g_tq.endQuery && g_tq.getQueryiv && g_tq.getQueryui64v;
+    t->lastUs=time_now_us(); t->peakRssKb=peak_rss_kb();
+    if(t->name[0]) fprintf(stderr,"[ornament] telemetry: %s (%zu bytes, %s)\n", t->name, sizeof(TelemetryBlock), g_tq.gpu? "GPU timer queries" : "no GPU timers");
+    return t;
+}
+
+static void telemetry_close(Telemetry* t){
+    if(!t) return;
+#ifdef ORNAMENT_HAS_TELEMETRY
+    if(t->name[0]){ munmap(t->blk, sizeof(TelemetryBlock)); shm_unlink(t->name); free(t); return; }
+#endif
+    free(t->blk); free(t);
+}
+
+#ifdef ORNAMENT_HAS_TELEMETRY
+// Prints one consistent snapshot of a running ornament's block as JSON (--read-telemetry).
+static int telemetry_read(const char* name){
+    char path[256]; if(!telemetry_name(path, sizeof(path), name)){ fprintf(stderr,"bad telemetry name '%s'\n", name); return 0; }
+    int fd=shm_open(path, O_RDONLY, 0);
+    if(fd<0){ fprintf(stderr,"%s: %s\n", path, strerror(errno)); return 0; }
+    struct stat sb; const TelemetryBlock* b=MAP_FAILED;
+    if(fstat(fd,&sb)==0 && sb.st_size>=(off_t)sizeof(TelemetryBlock)) b=(const TelemetryBlock*)mmap(NULL, sizeof(TelemetryBlock), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(b==MAP_FAILED){ fprintf(stderr,"%s: not a telemetry block\n", path); return 0; }
+    if(memcmp(b->magic, TELEMETRY_MAGIC, 8)!=0 || b->version!=TELEMETRY_VERSION || b->size!=sizeof(TelemetryBlock)){
+        fprintf(stderr,"%s: unsupported telemetry block (version %u, %u bytes)\n", path, b->version, b->size); munmap((void*)b, sizeof(TelemetryBlock)); return 0;
+    }
+    TelemetryBlock c; int ok=telemetry_snapshot(b, &c);
+    munmap((void*)b, sizeof(TelemetryBlock));
+    if(!ok){ fprintf(stderr,"%s: writer never finished an update\n", path); return 0; }
+    double age=(double)(time_now_us()-c.publishUs)/1000.0;
+    printf("{\"pid\":%d,\"seq\":%llu,\"age_ms\":%.3f,\"frames\":%llu,\"dropped_frames\":%llu,\"sim_steps\":%llu,\"edges\":%llu,\"wall_s\":%.3f,\"sim_time\":%.3f,\"fps\":%.3f,\"budget_ms\":%.3f,\"update_ms\":%.4f,"
+           "\"shapes\":%d,\"windows\":%d,\"paused\":%d,\"fps_cap\":%d,\"arena_bytes\":%llu,\"peak_rss_kb\":%lld,\"frame_buckets\":[",
+           c.pid, (unsigned long long)atomic_load_explicit(&c.seq, memory_order_relaxed), age, (unsigned long long)c.frames, (unsigned long long)c.droppedFrames, (unsigned long long)c.simSteps, (unsigned long long)c.edges,
+           c.wallSec, c.simTime, c.fps, c.budgetSec*1000.0, c.updateMs, c.shapes, c.windows, c.paused, c.fpsCap, (unsigned long long)c.arenaBytes, (long long)c.peakRssKb);
+    for(int k=0;k<TELEMETRY_BUCKETS;k++) printf("%s%llu", k? "," : "", (unsigned long long)c.frameBucket[k]);
+    printf("],\"win\":[");
+    for(int w=0;w<c.windows && w<TELEMETRY_MAX_WINDOWS;w++){
+        const TelemetryWindow* v=&c.win[w];
+        printf("%s{\"monitor\":%d,\"width\":%d,\"height\":%d,\"shapes\":%d,\"frames\":%llu,\"frame_ms\":[%.4f,%.4f,%.4f,%.4f],\"gpu_ms\":[%.4f,%.4f,%.4f,%.4f]}",
+               w? "," : "", v->monIndex, v->width, v->height, v->shapes, (unsigned long long)v->frames,
+               v->frameMs[0], v->frameMs[1], v->frameMs[2], v->frameMs[3], v->gpuMs[0], v->gpuMs[1], v->gpuMs[2], v->gpuMs[3]);
+    }
+    printf("]}\n");
+    return 1;
+}
+#else
+static int telemetry_read(const char* name){ fprintf(stderr,"--read-telemetry needs POSIX shared memory (%s)\n", name); return 0; }
+#endif
+
+// Appends x, evicting the oldest sample once full: a binary search and a short memmove each
+// way instead of sorting the history whenever it is published.
+static void series_push(TelemetrySeries* s, float x){
+    int k=s->n<TELEMETRY_HISTORY? s->n : TELEMETRY_HISTORY, lo=0, hi;
+    float* v=s->sorted;
+    if(k==TELEMETRY_HISTORY){
+        float old=s->ring[s->n & (TELEMETRY_HISTORY-1)];
+        for(hi=k; lo<hi;){ int m=(lo+hi)/2; if(v[m]<old) lo=m+1; else hi=m; }
+        memmove(v+lo, v+lo+1, sizeof(float)*(size_t)(k-1-lo)); k--; lo=0;
+    }
+    for(hi=k; lo<hi;){ int m=(lo+hi)/2; if(v[m]<=x) lo=m+1; else hi=m; }
+    memmove(v+lo+1, v+lo, sizeof(float)*(size_t)(k-lo)); v[lo]=x;
+    s->ring[s->n++ & (TELEMETRY_HISTORY-1)]=x;
+}
+// p50, p90, p99 and max of the series.
+static void series_percentiles(const TelemetrySeries* s, float out[4]){
+    int k=s->n<TELEMETRY_HISTORY? s->n : TELEMETRY_HISTORY; const float* v=s->sorted;
+    if(k==0){ out[0]=out[1]=out[2]=out[3]=0; return; }
+    out[0]=v[(k-1)*50/100]; out[1]=v[(k-1)*90/100]; out[2]=v[(k-1)*99/100]; out[3]=v[k-1];
+}
+
+// Window `sw` is about to draw (its context current): collects finished timer queries and
+// starts this frame's.
+static void telemetry_window_begin(ScreenWindow* sw){
+    if(!sw->tm && !(sw->tm=(TelemetrySlot*)calloc(1, sizeof(TelemetrySlot)))) return;
+    TelemetrySlot* s=sw->tm;
+    if(!g_tq.gpu) return;
+    if(!s->query[0]) g_tq.genQueries(TELEMETRY_QUERIES, s->query);
+    for(int q=0;q<TELEMETRY_QUERIES;q++) if(s->issued[q]){
+        GLint ready=0; g_tq.getQueryiv(s->query[q], GL_QUERY_RESULT_AVAILABLE, &ready);
+        if(!ready) continue;
+        uint64_t ns=0; g_tq.getQueryui64v(s->query[q], GL_QUERY_RESULT, &ns); s->issued[q]=0;
+        if(!s->gpuWarm++) continue; // llvmpipe reports garbage for a context's first query
+        series_push(&s->gpuMs, (float)((double)ns*1e-6));
+    }
+    int q=s->qnext; // still pending after TELEMETRY_QUERIES frames: give up on it
+    g_tq.beginQuery(GL_TIME_ELAPSED, s->query[q]); s->issued[q]=1; s->qnext=(q+1)%TELEMETRY_QUERIES;
+}
+// Draw submitted; before the present.
+static void telemetry_window_drawn(const ScreenWindow* sw){ if(g_tq.gpu && sw->tm) g_tq.endQuery(GL_TIME_ELAPSED); }
+// Presented: `us` is the window's CPU time for draw + present.
+static void telemetry_window_done(ScreenWindow* sw, uint64_t us){
+    TelemetrySlot* s=sw->tm; if(!s) return;
+    series_push(&s->frameMs, (float)us/1000.0f); s->frames++;
+}
+static void telemetry_window_release(ScreenWindow* sw){
+    TelemetrySlot* s=sw->tm; if(!s) return;
+    if(s->query[0]) g_tq.deleteQueries(TELEMETRY_QUERIES, s->query);
+    free(s); sw->tm=NULL;
+}
+
+// End of frame: everything is computed first, so the writer holds seq odd only for the copy.
+static void telemetry_publish(Telemetry* t, const FrameStats* st, const ScreenSet* scr, int shapes, const Options* opt, int paused, double startSec, double simTime, uint64_t updateUs, long long edges){
+    uint64_t now=time_now_us();
+    double frameSec=(double)(now-t->lastUs)*1e-6; t->lastUs=now;
+    t->frameSec[t->nFrames++ & (TELEMETRY_HISTORY-1)]=(float)frameSec;
+    if((t->nFrames & (TELEMETRY_HISTORY-1))==0) t->peakRssKb=peak_rss_kb();
+    int bk=0; while(bk<TELEMETRY_BUCKETS-1 && frameSec*1000.0>TELEMETRY_BUCKET_MS[bk]) bk++;
+    t->bucket[bk]++; t->frameSecSum+=frameSec;
+    // a frame that overran its budget by half or more dropped one frame per budget it took
+    double budget=opt->fpsCap>0? 1.0/opt->fpsCap : 0.0;
+    if(budget==0.0 && !opt->headless && opt->vsync){ int hz=0; for(int w=0;w<scr->count;w++) if(scr->arr[w].refreshHz>0 && (!hz || scr->arr[w].refreshHz<hz)) hz=scr->arr[w].refreshHz; if(hz) budget=1.0/hz; }
+    if(budget>0 && frameSec>1.5*budget) t->dropped+=(uint64_t)(frameSec/budget+0.5)-1;
+    int k=t->nFrames<TELEMETRY_HISTORY? t->nFrames : TELEMETRY_HISTORY; double span=0;
+    for(int i=0;i<k;i++) span+=t->frameSec[i];
+    TelemetryWindow win[TELEMETRY_MAX_WINDOWS]; int nw=scr->count<TELEMETRY_MAX_WINDOWS? scr->count : TELEMETRY_MAX_WINDOWS;
+    memset(win, 0, sizeof(win));
+    for(int w=0;w<nw;w++){
+        const ScreenWindow* sw=&scr->arr[w]; const TelemetrySlot* s=sw->tm;
+        win[w].monIndex=sw->monIndex; win[w].width=sw->width; win[w].height=sw->height; win[w].shapes=sw->count;
+        if(s){ win[w].frames=s->frames; series_percentiles(&s->frameMs, win[w].frameMs); series_percentiles(&s->gpuMs, win[w].gpuMs); }
+    }
+
+    TelemetryBlock* b=t->blk;
+    uint64_t seq=atomic_load_explicit(&b->seq, memory_order_relaxed);
+    atomic_store_explicit(&b->seq, seq+1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    b->frames=(uint64_t)st->frames; b->simSteps=(uint64_t)st->simSteps; b->edges=(uint64_t)edges; b->publishUs=now;
+    b->wallSec=(double)now*1e-6-startSec; b->simTime=simTime; b->fps=span>0? (double)k/span : 0.0; b->updateMs=(float)updateUs/1000.0f;
+    b->shapes=shapes; b->windows=nw; b->paused=paused; b->fpsCap=opt->fpsCap;
+    b->arenaBytes=(uint64_t)atomic_load(&g_arenaReserved); b->peakRssKb=t->peakRssKb;
+    memcpy(b->win, win, sizeof(win));
+    b->droppedFrames=t->dropped; memcpy(b->frameBucket, t->bucket, sizeof(t->bucket)); b->frameSecSum=t->frameSecSum; b->budgetSec=budget;
+    atomic_store_explicit(&b->seq, seq+2, memory_order_release);
+}
+
+// --------------------------- Metrics exporter (Prometheus textfile) ---------------------------
+// --metrics-file PATH: a background thread takes a telemetry snapshot every --metrics-interval
+// seconds (default 15) and writes it in Prometheus text format for node_exporter's textfile
+// collector: PATH.tmp first, then rename() over PATH, so a scrape never sees half a file. Only
+// the snapshot is shared with the render thread; formatting, file I/O and the current-RSS
+// lookup happen here. PATH is removed at exit so a stopped instance drops out of the fleet.
+#define METRICS_INTERVAL_DEFAULT 15.0
+
+typedef struct { Telemetry* t; const char* path; double interval; Thread thread; atomic_int quit; } MetricsExporter;
+
+static void sleep_ms(int ms){
+#ifdef _WIN32
+    Sleep((DWORD)ms);
+#else
+    struct timespec ts={ ms/1000, (long)(ms%1000)*1000000L }; nanosleep(&ts, NULL);
+#endif
+}
+
+// Current resident set size; the peak where the platform offers nothing cheaper.
+static int64_t rss_bytes(void){
+#ifdef __linux__
+    FILE* f=fopen("/proc/self/statm","r"); long pages=0, resident=0;
+    if(f){ int n=fscanf(f, "%ld %ld", &pages, &resident); fclose(f); if(n==2) return (int64_t)resident*sysconf(_SC_PAGESIZE); }
+#endif
+    return (int64_t)peak_rss_kb()*1024;
+}
+
+static const char* const WINDOW_STAT[4]={ "p50", "p90", "p99", "max" }; // TelemetryWindow percentile order
+
+static void metric_head(FILE* f, const char* name, const char* type, const char* help){ fprintf(f, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type); }
+
+static int metrics_write(const MetricsExporter* m){
+    TelemetryBlock c;
+    if(!telemetry_snapshot(m->t->blk, &c)) return 0;
+    char tmp[4096]; snprintf(tmp, sizeof(tmp), "%s.tmp", m->path);
+    FILE* f=fopen(tmp, "wb"); if(!f) return 0;
+    double age=c.frames? (double)(time_now_us()-c.publishUs)*1e-6 : 0.0;
+    metric_head(f, "ornament_frames_total", "counter", "Frames rendered.");
+    fprintf(f, "ornament_frames_total %llu\n", (unsigned long long)c.frames);
+    metric_head(f, "ornament_dropped_frames_total", "counter", "Frame budgets missed (1/fps cap, or the monitor refresh with vsync).");
+    fprintf(f, "ornament_dropped_frames_total %llu\n", (unsigned long long)c.droppedFrames);
+    metric_head(f, "ornament_fps", "gauge", "Frames per second over the last 128 frames.");
+    fprintf(f, "ornament_fps %.3f\n", c.fps);
+    metric_head(f, "ornament_frame_budget_seconds", "gauge", "Frame budget used for dropped frames (0 = none).");
+    fprintf(f, "ornament_frame_budget_seconds %.6f\n", c.budgetSec);
+    metric_head(f, "ornament_frame_seconds", "histogram", "Time between frames.");
+    uint64_t cum=0;
+    for(int k=0;k<TELEMETRY_BUCKETS-1;k++){ cum+=c.frameBucket[k]; fprintf(f, "ornament_frame_seconds_bucket{le=\"%g\"} %llu\n", TELEMETRY_BUCKET_MS[k]/1000.0, (unsigned long long)cum); }
+    cum+=c.frameBucket[TELEMETRY_BUCKETS-1];
+    fprintf(f, "ornament_frame_seconds_bucket{le=\"+Inf\"} %llu\nornament_frame_seconds_sum %.6f\nornament_frame_seconds_count %llu\n", (unsigned long long)cum, c.frameSecSum, (unsigned long long)cum);
+    metric_head(f, "ornament_window_cpu_seconds", "gauge", "Per-window draw+present CPU time over the last 128 frames, by stat (p50, p90, p99, max).");
+    for(int w=0;w<c.windows && w<TELEMETRY_MAX_WINDOWS;w++) for(int q=0;q<4;q++)
+        fprintf(f, "ornament_window_cpu_seconds{window=\"%d\",monitor=\"%d\",stat=\"%s\"} %.6f\n", w, c.win[w].monIndex, WINDOW_STAT[q], c.win[w].frameMs[q]/1000.0);
+    metric_head(f, "ornament_window_gpu_seconds", "gauge", "Per-window GPU time of all glow passes over the last 128 frames, by stat (p50, p90, p99, max); 0 without timer queries.");
+    for(int w=0;w<c.windows && w<TELEMETRY_MAX_WINDOWS;w++) for(int q=0;q<4;q++)
+        fprintf(f, "ornament_window_gpu_seconds{window=\"%d\",monitor=\"%d\",stat=\"%s\"} %.6f\n", w, c.win[w].monIndex, WINDOW_STAT[q], c.win[w].gpuMs[q]/1000.0);
+    metric_head(f, "ornament_window_shapes", "gauge", "Shapes drawn per window.");
+    for(int w=0;w<c.windows && w<TELEMETRY_MAX_WINDOWS;w++) fprintf(f, "ornament_window_shapes{window=\"%d\",monitor=\"%d\"} %d\n", w, c.win[w].monIndex, c.win[w].shapes);
+    metric_head(f, "ornament_shapes", "gauge", "Shapes in the scene.");
+    fprintf(f, "ornament_shapes %d\n", c.shapes);
+    metric_head(f, "ornament_windows", "gauge", "Windows (screens) being drawn.");
+    fprintf(f, "ornament_windows %d\n", c.windows);
+    metric_head(f, "ornament_edges", "gauge", "Line segments submitted in the last frame, all glow passes.");
+    fprintf(f, "ornament_edges %llu\n", (unsigned long long)c.edges);
+    metric_head(f, "ornament_paused", "gauge", "1 while paused over the control socket.");
+    fprintf(f, "ornament_paused %d\n", c.paused);
+    metric_head(f, "ornament_resident_memory_bytes", "gauge", "Resident set size.");
+    fprintf(f, "ornament_resident_memory_bytes %lld\n", (long long)rss_bytes());
+    metric_head(f, "ornament_resident_memory_peak_bytes", "gauge", "Peak resident set size.");
+    fprintf(f, "ornament_resident_memory_peak_bytes %lld\n", (long long)peak_rss_kb()*1024);
+    metric_head(f, "ornament_arena_bytes", "gauge", "Bytes reserved by arenas.");
+    fprintf(f, "ornament_arena_bytes %llu\n", (unsigned long long)c.arenaBytes);
+    metric_head(f, "ornament_last_frame_age_seconds", "gauge", "Seconds since the render loop last published; grows if it hangs.");
+    fprintf(f, "ornament_last_frame_age_seconds %.3f\n", age);
+    int ok=!ferror(f); ok&=fclose(f)==0;
+#ifdef _WIN32
+    ok=ok && MoveFileExA(tmp, m->path, MOVEFILE_REPLACE_EXISTING);
+#else
+    ok=ok && rename(tmp, m->path)==0;
+#endif
+    if(!ok) remove(tmp);
+    return ok;
+}
+
+static void metrics_main(void* arg){
+    MetricsExporter* m=(MetricsExporter*)arg;
+    trace_thread_name("metrics");
+    int warned=0; uint64_t next=time_now_us()+(uint64_t)(m->interval*1e6);
+    while(!atomic_load(&m->quit)){
+        if(time_now_us()<next){ sleep_ms(50); continue; }
+        next+=(uint64_t)(m->interval*1e6);
+        if(!metrics_write(m) && !warned){ fprintf(stderr,"warn: cannot write metrics to %s\n", m->path); warned=1; }
+    }
+}
+
+static MetricsExporter* metrics_start(Telemetry* t, const char* path, double interval){
+    MetricsExporter* m=(MetricsExporter*)calloc(1, sizeof(MetricsExporter)); if(!m) return NULL;
+    m->t=t; m->path=path; m->interval=interval; atomic_init(&m->quit, 0);
+    if(!thread_start(&m->thread, metrics_main, m)){ free(m); return NULL; }
+    fprintf(stderr,"[ornament] metrics: %s every %g s\n", path, interval);
+    return m;
+}
+
+// Call before the telemetry block goes away.
+static void metrics_stop(MetricsExporter* m){
+    if(!m) return;
+    atomic_store(&m->quit, 1); thread_join(m->thread);
+    remove(m->path);
+    free(m);
+}
+
+// --------------------------- Main ---------------------------
+// Tools such as microbench.c #include this file with ORNAMENT_NO_MAIN to reuse its kernels.
+#ifndef ORNAMENT_NO_MAIN
+// Each worker appends meshes to its own arena, so no locking is needed.
+typedef struct { ShapeRuntime* runtime; Arena* arenas; } GeomJob;
+static void build_geom_job(void* ctx, int begin, int end){
+    GeomJob* g=(GeomJob*)ctx; Arena* ar=&g->arenas[t_worker];
+    for(int i=begin;i<end;i++) if(!g->runtime[i].geom.verts) g->runtime[i].geom=make_shape_geom(ar, g->runtime[i].shape, g->runtime[i].lod);
+}
+
+int main(int argc, char** argv){
+    int control=-1; // windowed runs serve $XDG_RUNTIME_DIR/ornament.sock unless told otherwise
+    static char controlPath[4096];
+    Options opt = { .iniPath="./ornament.ini", .brightness=1.0f, .thickness=2.0f, .vsync=1, .headlessW=1920, .headlessH=1080, .simHz=60, .watch=-1, .metricsInterval=METRICS_INTERVAL_DEFAULT, .seed=(uint64_t)time(NULL) };
+    for(int i=1;i<argc;i++){
+        if(strcmp(argv[i],"--config")==0 && i+1<argc) opt.iniPath=argv[++i];
+        else if(strcmp(argv[i],"--brightness")==0 && i+1<argc) opt.brightness=(float)atof(argv[++i]);
+        else if(strcmp(argv[i],"--thickness")==0 && i+1<argc) opt.thickness=(float)atof(argv[++i]);
+        else if(strcmp(argv[i],"--fps")==0 && i+1<argc) opt.fpsCap=atoi(argv[++i]);
+        else if(strcmp(argv[i],"--no-vsync")==0) opt.vsync=0;
+        else if(strcmp(argv[i],"--trace")==0 && i+1<argc) trace_init(argv[++i]);
+        else if(strcmp(argv[i],"--headless")==0) opt.headless=1;
+        else if(strcmp(argv[i],"--headless-size")==0 && i+1<argc){
+            if(sscanf(argv[++i],"%dx%d",&opt.headlessW,&opt.headlessH)!=2 || opt.headlessW<=0 || opt.headlessH<=0){ fprintf(stderr,"warn: bad --headless-size, using 1920x1080\n"); opt.headlessW=1920; opt.headlessH=1080; }
+            else opt.headlessSizeSet=1;
+        }
+        else if(strcmp(argv[i],"--frames")==0 && i+1<argc) opt.maxFrames=atoi(argv[++i]);
+        else if(strcmp(argv[i],"--stats-json")==0 && i+1<argc) opt.statsPath=argv[++i];
+        else if(strcmp(argv[i],"--seed")==0 && i+1<argc) opt.seed=strtoull(argv[++i], NULL, 0);
+        else if(strcmp(argv[i],"--record")==0 && i+1<argc) opt.recordPath=argv[++i];
+        else if(strcmp(argv[i],"--replay")==0 && i+1<argc) opt.replayPath=argv[++i];
+        else if(strcmp(argv[i],"--replay-realtime")==0) opt.replayRealtime=1;
+        else if(strcmp(argv[i],"--threads")==0 && i+1<argc) opt.threads=atoi(argv[++i]);
+        else if(strcmp(argv[i],"--anim")==0 && i+1<argc){ const char* m=argv[++i]; if(strcmp(m,"analytic")==0) opt.analytic=1; else if(strcmp(m,"integrated")==0) opt.analytic=0; else fprintf(stderr,"warn: unknown --anim model '%s'\n", m); }
+        else if(strcmp(argv[i],"--start-time")==0 && i+1<argc) opt.startTime=atof(argv[++i]);
+        else if(strcmp(argv[i],"--trig")==0 && i+1<argc){ const char* m=argv[++i]; if(strcmp(m,"libm")==0) g_trigLibm=1; else if(strcmp(m,"fast")==0) g_trigLibm=0; else fprintf(stderr,"warn: unknown --trig mode '%s'\n", m); }
+        else if(strcmp(argv[i],"--sim-hz")==0 && i+1<argc) { int hz=atoi(argv[++i]); opt.simHz=CLAMP(hz,1,1000); }
+        else if(strcmp(argv[i],"--compile-config")==0 && i+1<argc) opt.compilePath=argv[++i];
+        else if(strcmp(argv[i],"-o")==0 && i+1<argc) opt.outPath=argv[++i];
+        else if(strcmp(argv[i],"--no-meshes")==0) opt.noSceneMeshes=1;
+        else if(strcmp(argv[i],"--scene")==0 && i+1<argc) opt.scenePath=argv[++i];
+        else if(strcmp(argv[i],"--watch")==0) opt.watch=1;
+        else if(strcmp(argv[i],"--layout")==0 && i+1<argc){ const char* m=argv[++i]; if(strcmp(m,"stacked")==0) g_layoutStacked=1; else if(strcmp(m,"packed")==0) g_layoutStacked=0; else fprintf(stderr,"warn: unknown --layout '%s'\n", m); }
+        else if(strcmp(argv[i],"--no-watch")==0) opt.watch=0;
+        else if(strcmp(argv[i],"--debug-overdraw")==0) opt.debugOverdraw=1;
+        else if(strcmp(argv[i],"--control")==0 && i+1<argc){ opt.controlPath=argv[++i]; control=1; }
+        else if(strcmp(argv[i],"--no-control")==0) control=0;
+        else if(strcmp(argv[i],"--telemetry")==0 && i+1<argc) opt.telemetryName=argv[++i];
+        else if(strcmp(argv[i],"--metrics-file")==0 && i+1<argc) opt.metricsPath=argv[++i];
+        else if(strcmp(argv[i],"--metrics-interval")==0 && i+1<argc){ double v=atof(argv[++i]); opt.metricsInterval=CLAMP(v,0.1,3600.0); }
+        else if(strcmp(argv[i],"--read-telemetry")==0 && i+1<argc) return telemetry_read(argv[++i])? 0 : 1;
+    }
+    if(opt.compilePath){
+        if(!opt.outPath){ fprintf(stderr,"--compile-config needs -o out.orn\n"); return 1; }
+        return compile_scene(opt.compilePath, opt.outPath, !opt.noSceneMeshes)? 0 : 1;
+    }
+    trace_thread_name("main");
+
+    Session rec={0}, rep={0};
+    if(opt.replayPath){
+        if(!session_load(&rep, opt.replayPath)) return 1;
+        if(opt.recordPath){ fprintf(stderr,"warn: --record ignored while replaying\n"); opt.recordPath=NULL; }
+        opt.seed=rep.hdr.seed;
+        // the recorded timeline options win; say so where the command line asked for others
+        int analytic=(rep.hdr.flags&SESSION_ANALYTIC)!=0, libm=(rep.hdr.flags&SESSION_TRIG_LIBM)!=0, stacked=(rep.hdr.flags&SESSION_LAYOUT_STACKED)!=0;
+        if(opt.simHz!=(int)rep.hdr.simHz) fprintf(stderr,"warn: replay uses the recorded --sim-hz %u (not %d)\n", rep.hdr.simHz, opt.simHz);
+        if(opt.analytic!=analytic) fprintf(stderr,"warn: replay uses the recorded --anim %s\n", analytic? "analytic" : "integrated");
+        if(analytic && opt.startTime!=rep.hdr.startTime) fprintf(stderr,"warn: replay uses the recorded --start-time %g\n", rep.hdr.startTime);
+        if(g_trigLibm!=libm) fprintf(stderr,"warn: replay uses the recorded --trig %s\n", libm? "libm" : "fast");
+        if(g_layoutStacked!=stacked) fprintf(stderr,"warn: replay uses the recorded --layout %s\n", stacked? "stacked" : "packed");
+        opt.simHz=(int)rep.hdr.simHz; opt.analytic=analytic; opt.startTime=rep.hdr.startTime; g_trigLibm=libm; g_layoutStacked=stacked;
+        fprintf(stderr,"[ornament] replaying %u frames from %s (seed %llu)\n", rep.hdr.frameCount, opt.replayPath, (unsigned long long)rep.hdr.seed);
+    }
+
+    uint64_t tz=trace_begin();
+    Arena scene={0}; // screens and startup tables; freed in one step at exit
+    static Arena geomArenas[JOB_MAX_WORKERS];
+    ShapeSet shapes={0}; // config and per-shape state; replaced wholesale by a hot reload
+    SceneFile sceneFile={0}; ShapeList list; uint64_t configHash;
+    if(opt.scenePath && !scene_open(&sceneFile, opt.scenePath)){ fprintf(stderr,"warn: --scene rejected, loading %s\n", opt.iniPath); opt.scenePath=NULL; }
+    if(opt.scenePath){
+        list = scene_shape_list(&sceneFile, &shapes.arena);
+        configHash = sceneFile.hdr->configHash; opt.iniPath = opt.scenePath;
+        trace_end("load_scene", tz);
+    } else {
+        list = load_ini(opt.iniPath, &shapes.arena);
+        configHash = hash_file(opt.iniPath);
+        trace_end("load_ini", tz);
+    }
+    if(opt.replayPath && configHash!=rep.hdr.configHash) fprintf(stderr,"warn: %s differs from the config the session was recorded with\n", opt.iniPath);
+
+    int monCount=0; GLFWmonitor** mons=NULL;
+    if(opt.headless){
+        if(opt.maxFrames<=0 && !opt.replayPath){ opt.maxFrames=HEADLESS_DEFAULT_FRAMES; fprintf(stderr,"[ornament] headless: no --frames, stopping after %d\n", opt.maxFrames); }
+        tz=trace_begin();
+        if(!headless_init()){ fprintf(stderr,"Failed to create headless GL context (needs Mesa EGL surfaceless or OSMesa)\n"); return 1; }
+        trace_end("headless_init", tz);
+        // one virtual screen per SCREEN index, up to the highest one configured
+        for(int i=0;i<list.count;i++) if(list.items[i].screen+1>monCount) monCount=list.items[i].screen+1;
+        monCount=CLAMP(monCount,1,HEADLESS_MAX_SCREENS);
+    } else {
+        tz=trace_begin();
+        if(!glfwInit()){ fprintf(stderr,"Failed to init GLFW\n"); return 1; }
+        trace_end("glfwInit", tz);
+
+        mons = glfwGetMonitors(&monCount);
+        if(monCount<=0){ fprintf(stderr,"No monitors found\n"); glfwTerminate(); return 1; }
+    }
 
     // Determine unique screen indices used
-    int* need = calloc(monCount, sizeof(int)); int unique=0;
+    int* need = (int*)arena_calloc(&scene, monCount, sizeof(int), 8); int unique=0;
     for(int i=0;i<list.count;i++){
         int idx = list.items[i].screen; if(idx<0) idx=0; if(idx>=monCount) idx=monCount-1; if(!need[idx]){ need[idx]=1; unique++; }
     }
     if(unique==0){ need[0]=1; unique=1; }
 
-    ScreenSet scr={0}; scr.arr = (ScreenWindow*)calloc(unique, sizeof(ScreenWindow));
-
-    glfwWindowHint(GLFW_DECORATED, GLFW_FALSE);
-    glfwWindowHint(GLFW_TRANSPARENT_FRAMEBUFFER, GLFW_TRUE);
-    glfwWindowHint(GLFW_SAMPLES, 4);
+    ScreenSet scr={0}; scr.arr = (ScreenWindow*)calloc((size_t)unique, sizeof(ScreenWindow));
+    if(!scr.arr){ fprintf(stderr,"Out of memory\n"); return 1; }
+
+    if(!opt.headless){
+        glfwWindowHint(GLFW_DECORATED, GLFW_FALSE);
+        glfwWindowHint(GLFW_TRANSPARENT_FRAMEBUFFER, GLFW_TRUE);
+        glfwWindowHint(GLFW_SAMPLES, 4);
+        // hidden context the windows share with; outlives monitor hotplugs (see Monitors)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        g_shareCtx = glfwCreateWindow(1, 1, "Ornament", NULL, NULL);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+        if(g_shareCtx) glfwSetMonitorCallback(on_monitor_event);
+        else fprintf(stderr,"warn: cannot create the hidden share context; monitor hotplug disabled\n");
+    }
 
-    // Create windows for required monitors
+    // Create windows (or offscreen targets) for required monitors
     int wi=0;
     for(int m=0;m<monCount;m++) if(need[m]){
-        const GLFWvidmode* vm = glfwGetVideoMode(mons[m]);
-        GLFWwindow* w = glfwCreateWindow(vm->width, vm->height, "Ornament", NULL, NULL);
-        if(!w){ fprintf(stderr,"Failed to create window for monitor %d\n", m); continue; }
-        // position window at monitor origin
-        int mx,my; glfwGetMonitorPos(mons[m], &mx, &my); glfwSetWindowPos(w, mx, my);
-        glfwMakeContextCurrent(w);
-        glfwSwapInterval(vsync?1:0);
-        ScreenWindow sw={0}; sw.win=w; sw.monitor=mons[m]; sw.monIndex=m; sw.width=vm->width; sw.height=vm->height; float xs=1,ys=1; glfwGetWindowContentScale(w,&xs,&ys); sw.contentScale.x=xs; sw.contentScale.y=ys; sw.cam = make_camera(sw.width, sw.height); scr.arr[wi++]=sw;
+        tz=trace_begin();
+        ScreenWindow sw={0}; sw.monIndex=m;
+        if(opt.headless){
+            const SessionScreen* ss = (opt.replayPath && !opt.headlessSizeSet)? session_screen(&rep, m) : NULL;
+            if(!headless_create_target(&sw, ss? ss->width : opt.headlessW, ss? ss->height : opt.headlessH)){ fprintf(stderr,"Failed to create offscreen target for screen %d\n", m); continue; }
+        } else if(!create_screen_window(&sw, mons[m], m, opt.vsync)){ fprintf(stderr,"Failed to create window for monitor %d\n", m); continue; }
+        sw.cam = make_camera(sw.width, sw.height); scr.arr[wi++]=sw;
+        trace_end_arg("create_window", tz, "monitor", m);
     }
-    scr.count=wi; if(scr.count==0){ fprintf(stderr,"No windows created\n"); glfwTerminate(); return 1; }
-
-    // Build runtime objects, grouped by monitor
-    ShapeRuntime* runtime = (ShapeRuntime*)calloc(list.count, sizeof(ShapeRuntime)); int rc=0;
-
-    // For overlap mitigation per quadrant per screen
-    int quadrantCount[16][POS_COUNT]; memset(quadrantCount,0,sizeof(quadrantCount));
-
+    scr.count=wi; if(scr.count==0){ fprintf(stderr,"No windows created\n"); if(opt.headless) headless_shutdown(); else glfwTerminate(); return 1; }
+
+    scr.monCount=monCount;
+
+    // Build runtime objects, grouped by window
+    int* order = sort_by_window(&list, &scr, &shapes.arena);
+    shapes.list=list;
+    if(!order || !shapeset_alloc(&shapes, list.count)){ fprintf(stderr,"Out of memory\n"); return 1; }
+    ShapeRuntime* runtime=shapes.runtime; int rc=0;
+
+    tz=trace_begin();
+    job_init(opt.threads);
+    // a compiled scene carries resolved positions; they are reused unless they were resolved
+    // for more screens than this machine has (folded screens would then overlap unpacked)
+    vec3* placed = (vec3*)arena_alloc(&scene, sizeof(vec3)*(size_t)list.count, 16);
+    if(!placed){ fprintf(stderr,"Out of memory\n"); return 1; }
+    if(opt.scenePath && (int)sceneFile.hdr->placedScreens<=monCount)
+        for(int i=0;i<list.count;i++) placed[i]=v3(sceneFile.shapes[order[i]].x, sceneFile.shapes[order[i]].y, 0);
+    else {
+        LayoutStats ls={0};
+        place_shapes(&list, monCount, placed, &ls);
+        fprintf(stderr,"[ornament] layout: %d shapes, bounding-circle overdraw %.2fx (fixed-step layout %.2fx), %.2f ms\n", list.count, ls.overdraw, ls.stackedOverdraw, ls.ms);
+    }
+    int needGeom=0;
     for(int i=0;i<list.count;i++){
         ShapeConfig sc = list.items[i];
-        int mon = sc.screen; if(mon<0) mon=0; if(mon>=monCount) mon=monCount-1;
-        // placement
-        vec3 anc = anchor_to_ndc(sc.pos);
-        vec3 pos = anchor_margin(anc, 0.12f); // ~6% of each side -> NDC ~0.12
-        int qn = quadrantCount[mon][sc.pos]++;
-        float off = 0.05f * (float)qn; pos.x += (anc.x>=0? -off: off); pos.y += (anc.y>=0? -off: off);
-
-        // shape geometry
-        WireGeom g={0};
-        switch(sc.shape){
-            case SH_CUBE: g=make_cube(); break;
-            case SH_PYRAMID: g=make_pyramid(); break;
-            case SH_OCT: g=make_octahedron(); break;
-            case SH_SPHERE: g=make_sphere(10,16); break;
-            case SH_TORUS: g=make_torus(32,12,1.0f,0.35f); break;
-            default: g=make_cube(); break;
-        }
-
         ShapeRuntime R={0};
-        R.shape=sc.shape; R.color=sc.color; R.hue=frand01(); R.hueSpeed=frand_range(0.25f,0.5f);
-        R.orient=q_ident(); R.target=q_from_euler(frand_range(-1,1), frand_range(-1,1), frand_range(-1,1));
-        R.spinY=frand_range(180,360); R.spinX=frand_range(15,45);
-        R.reorientTimer=frand_range(4,8); R.reorientDur=frand_range(1.5f,2.5f); R.reorientT=0.0f;
-        R.worldPos=pos; R.geom=g;
+        runtime_apply_config(&R, &sc, placed[i]); R.window=screen_window(&scr, sc.screen);
+        if(opt.scenePath) R.geom=scene_mesh(&sceneFile, order[i]);
+        if(!R.geom.verts) needGeom=1;
+        anim_spawn_id(&shapes.anim, rc, opt.seed, (uint32_t)order[i]); anim_scale_spin(&shapes.anim, rc, sc.spin);
         runtime[rc++]=R;
     }
+    // shape geometry: independent per shape, so it is built on the job pool
+    GeomJob gj={ runtime, geomArenas };
+    if(needGeom) job_parallel_for("make_geom", rc, 16, build_geom_job, &gj);
+    trace_end("geometry", tz);
+    shapes.count=rc; shapes.nextId=(uint32_t)rc;
+    bind_windows(&scr, runtime, rc);
+
+    if(opt.replayPath){
+        for(int i=0;i<scr.count;i++){
+            const SessionScreen* ss=session_screen(&rep, scr.arr[i].monIndex);
+            if(!ss || ss->width!=scr.arr[i].width || ss->height!=scr.arr[i].height || (int)rep.hdr.screenCount!=scr.count){ fprintf(stderr,"warn: screen layout differs from the recorded session\n"); break; }
+        }
+    }
+    if(opt.recordPath && !session_begin_record(&rec, opt.recordPath, &opt, configHash, &scr)) opt.recordPath=NULL;
 
-    // Assign start indices/counts per window
-    // We keep simple: store shapes in creation order; per window we compute on the fly during render which shapes belong.
-
-    app_loop(&scr, runtime, rc, brightness, thickness, fpsCap, vsync);
+    // hot reload only where nothing depends on the config staying fixed
+    if(opt.watch && (opt.scenePath || opt.replayPath || opt.recordPath)){ if(opt.watch>0) fprintf(stderr,"warn: --watch ignored with --scene/--record/--replay\n"); opt.watch=0; }
+    if(opt.watch<0) opt.watch=!opt.headless;
+    if(control<0 && !opt.headless && getenv("XDG_RUNTIME_DIR") && *getenv("XDG_RUNTIME_DIR")){
+        snprintf(controlPath, sizeof(controlPath), "%s/ornament.sock", getenv("XDG_RUNTIME_DIR")); opt.controlPath=controlPath;
+    }
+    if(control==0) opt.controlPath=NULL;
 
-    for(int i=0;i<rc;i++) free_geom(&runtime[i].geom);
-    free(runtime); free_list(&list); free(need);
+    app_loop(&scr, &shapes, &opt, opt.recordPath? &rec : NULL, opt.replayPath? &rep : NULL);
+    session_close(&rec); session_close(&rep);
 
-    for(int i=0;i<scr.count;i++) glfwDestroyWindow(scr.arr[i].win);
+    for(int i=0;i<scr.count;i++){
+        if(scr.arr[i].od || scr.arr[i].tm){ if(scr.arr[i].win) glfwMakeContextCurrent(scr.arr[i].win); overdraw_release(&scr.arr[i], i); telemetry_window_release(&scr.arr[i]); }
+        if(scr.arr[i].win) glfwDestroyWindow(scr.arr[i].win); else headless_destroy_target(&scr.arr[i]);
+    }
     free(scr.arr);
-    glfwTerminate();
+    anim_free(&shapes.anim);
+    arena_free(&shapes.arena);
+    for(int i=0;i<JOB_MAX_WORKERS;i++) arena_free(&geomArenas[i]);
+    arena_free(&scene);
+    scene_close(&sceneFile);
+    if(g_shareCtx) glfwDestroyWindow(g_shareCtx);
+    if(opt.headless) headless_shutdown(); else glfwTerminate();
+    job_shutdown();
+    trace_flush();
     return 0;
 }
+#endif // ORNAMENT_NO_MAIN
 
 // --------------------------- Rendering & Loop ---------------------------
 
@@ -501,119 +3158,182 @@ static void apply_proj_view(const Camera* c){
 
 static void set_color(vec3 c, float a, float brightness){ glColor4f(c.x*brightness, c.y*brightness, c.z*brightness, a); }
 
-static vec3 color_for(const ShapeRuntime* s, double t){
-    if(s->color==COL_RANDOM){ float h = fmodf(s->hue + (float)t*s->hueSpeed, 1.0f); return hsv2rgb(h, 1.0f, 1.0f); }
+static vec3 color_for(const ShapeRuntime* s, const ShapeAnim* a, int i, double t){
+    if(s->color==COL_RANDOM){ float h=(float)fmod((double)a->hue[i] + t*(double)a->hueSpeed[i], 1.0); return hsv2rgb(h, 1.0f, 1.0f); }
     return neon_palette(s->color);
 }
 
-static void update_shape(ShapeRuntime* s, float dt){
-    // update hue base
-    s->hue = fmodf(s->hue + s->hueSpeed*dt, 1.0f);
-    // reorientation timing
-    s->reorientTimer -= dt;
-    float spinScale=1.0f;
-    if(s->reorientTimer <= 0.0f || s->reorientT>0.0f){
-        if(s->reorientT==0.0f){ // start new
-            s->target = q_from_euler(frand_range(-1.5f,1.5f), frand_range(-1.5f,1.5f), frand_range(-1.5f,1.5f));
-        }
-        s->reorientT += dt / s->reorientDur;
-        if(s->reorientT >= 1.0f){ s->orient = s->target; s->reorientT=0.0f; s->reorientTimer = frand_range(4,8); }
-        else { s->orient = q_slerp(s->orient, s->target, s->reorientT); spinScale=0.5f; }
+// Fills the per-shape instance buffer (model matrices) for [begin,end); run on the job pool
+// after the update so draw only submits GL. The integrated model interpolates and builds
+// SIMD_WIDTH matrices at a time (begin must be a multiple of SIMD_WIDTH); the analytic model
+// evaluates each shape on its own.
+typedef struct { const ShapeRuntime* runtime; const ShapeAnim* anim; mat4* model; float alpha; int analytic; double time; } TransformJob;
+static void transform_job(void* ctx, int begin, int end){
+    TransformJob* t=(TransformJob*)ctx; const ShapeAnim* a=t->anim;
+    if(t->analytic){
+        for(int i=begin;i<end;i++){ const ShapeRuntime* r=&t->runtime[i]; t->model[i]=m4_trs(v3(r->worldPos.x,r->worldPos.y,0), anim_eval(a, i, t->time), SHAPE_SCALE*r->scale); }
+        return;
+    }
+    const vf alpha=vf_set1(t->alpha), zero=vf_set1(0.0f);
+    for(int i=begin;i<end;i+=SIMD_WIDTH){
+        vquat prev={ vf_load(a->px+i), vf_load(a->py+i), vf_load(a->pz+i), vf_load(a->pw+i) };
+        vquat cur={ vf_load(a->ox+i), vf_load(a->oy+i), vf_load(a->oz+i), vf_load(a->ow+i) };
+        vquat q=vq_slerp(prev, cur, alpha);
+        int lanes=end-i<SIMD_WIDTH? end-i : SIMD_WIDTH;
+        SIMD_ALIGNED float px[SIMD_WIDTH]={0}, py[SIMD_WIDTH]={0}, sc[SIMD_WIDTH]={0};
+        for(int l=0;l<lanes;l++){ const ShapeRuntime* r=&t->runtime[i+l]; px[l]=r->worldPos.x; py[l]=r->worldPos.y; sc[l]=SHAPE_SCALE*r->scale; }
+        vm4_trs_store(q, vf_load(px), vf_load(py), zero, vf_load(sc), &t->model[i], lanes);
     }
-    // continuous spin
-    float dYaw = s->spinY * spinScale * dt * (float)M_PI/180.0f;
-    float dPitch = s->spinX * spinScale * dt * (float)M_PI/180.0f;
-    quat dq = q_mul(q_from_axis_angle(v3(0,1,0), dYaw), q_from_axis_angle(v3(1,0,0), dPitch));
-    s->orient = q_mul(dq, s->orient);
 }
 
-static void draw_shape(const ShapeRuntime* s, const Camera* cam, float brightness, float thickness, double timeNow){
-    vec3 col = color_for(s, timeNow);
+// Returns the number of line segments submitted (all glow passes).
+static int draw_shape(const ShapeRuntime* s, const ShapeAnim* a, int idx, const mat4* model, const Camera* cam, float brightness, float thickness, double timeNow){
+    vec3 col = color_for(s, a, idx, timeNow);
 
-    // Model matrix
-    mat4 T = m4_translate(v3(s->worldPos.x, s->worldPos.y, 0));
-    mat4 R = m4_from_quat(s->orient); mat4 S = m4_scale(0.6f);
-    mat4 M = m4_mul(T, m4_mul(R,S));
-
-    glPushMatrix(); mult_matrix(&M);
+    glPushMatrix(); mult_matrix(model);
     glEnable(GL_BLEND); glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    if(g_overdrawPass) glBlendFunc(GL_ONE, GL_ONE); // each fragment adds 1.0 to its pixel's count
     glEnable(GL_DEPTH_TEST);
     #ifdef GL_LINE_SMOOTH
     glEnable(GL_LINE_SMOOTH);
     #endif
 
-    // 3-4 passes for glow
-    float widths[4] = { thickness*3.0f, thickness*1.8f, thickness*1.1f, thickness*0.6f };
-    float alphas[4] = { 0.15f, 0.35f, 0.8f, 1.0f };
-    int passes = 3; // 3 main passes; optional 4th is pretty but heavier
+    // GLOW= passes, outermost halo first: 3 is the classic look, 4 adds a bright core, fewer
+    // drop halos (1 = the main line only)
+    thickness *= s->width;
+    float widths[GLOW_MAX_PASSES] = { thickness*3.0f, thickness*1.8f, thickness*1.1f, thickness*0.6f };
+    float alphas[GLOW_MAX_PASSES] = { 0.15f, 0.35f, 0.8f, 1.0f };
+    int passes = CLAMP(s->glow, 1, GLOW_MAX_PASSES), first = passes<3? 3-passes : 0;
 
-    for(int i=0;i<passes;i++){
+    for(int i=first;i<first+passes;i++){
         #ifdef GL_LINE_WIDTH
         glLineWidth(widths[i] *  cam->proj.m[0]); // naive scale
         #endif
-        set_color(col, alphas[i], brightness);
+        if(g_overdrawPass) glColor4f(1,1,1,1); else set_color(col, alphas[i], brightness);
         draw_wire(&s->geom);
     }
     glPopMatrix();
+    return passes*s->geom.lcount;
 }
 
-static int shape_belongs_to_monitor(const ShapeRuntime* s, const ShapeList* L, int idx){
-    // At runtime we don't store back-reference; we assume order preserved: idx is mapping
-    (void)s; (void)L; (void)idx; return 1; // not used in this simplified renderer
-}
+// Instance buffer and job grains, sized for the current shape set.
+typedef struct { mat4* model; int updGrain, xfGrain; } DrawLists;
 
-static void app_loop(ScreenSet* scr, ShapeRuntime* runtime, int runtimeCount, float brightness, float thickness, int fpsCap, int vsync){
-    // Map shapes to screens by nearest monitor index from ini order.
-    // Build an array of indices per screen.
-    int monCount= scr->count; int* perCount = calloc(monCount, sizeof(int));
-    // Re-read using a heuristic: distribute evenly by anchor monitor proximity.
-    // Simpler: ask glfw which window contains the anchor x position (we stored monitor index implicitly by placement),
-    // but we cannot since we didn't keep that. Instead we assign by round-robin grouped by anchor sign; acceptable.
-    // For better correctness, many would track the screen in ShapeRuntime, omitted for brevity.
-
-    // We'll extend ShapeRuntime to include desired mon from worldPos sign? Quick fix: store mon index in unused z via casting.
-    // Since we didn't store, we fallback: assign all shapes to all windows if there is only one. If multiple, split evenly.
-
-    int totalWindows = scr->count;
-    int* start = calloc(monCount, sizeof(int));
-    int* count = calloc(monCount, sizeof(int));
-    for(int i=0;i<runtimeCount;i++) count[i%totalWindows]++;
-    for(int i=1;i<monCount;i++) start[i]=start[i-1]+count[i-1];
-    int* placed = calloc(monCount, sizeof(int));
-    int* mapIdx = malloc(sizeof(int)*runtimeCount);
-    for(int i=0;i<runtimeCount;i++){ int w=i%totalWindows; mapIdx[start[w]+placed[w]++]=i; }
+static void draw_lists_build(DrawLists* d, Arena* scratch, int runtimeCount){
+    d->model = (mat4*)arena_alloc(scratch, sizeof(mat4)*(size_t)runtimeCount, 64);
+    d->updGrain = job_grain(runtimeCount, 512, 8); d->xfGrain = job_grain(runtimeCount, 256, 8);
+}
 
-    double last = glfwGetTime();
+static void app_loop(ScreenSet* scr, ShapeSet* shapes, Options* opt, Session* rec, Session* rep){
+    Arena scratch={0}; // draw lists; released together when the shape set changes and at the end
+    DrawLists dl; draw_lists_build(&dl, &scratch, shapes->count);
+    Arena meshes={0}; // meshes of shapes added by a hot reload
+    IniWatch watch; if(opt->watch) ini_watch_open(&watch, opt->iniPath);
+    Control* ctl = opt->controlPath? control_open(opt->controlPath) : NULL;
+    int paused = 0; // "pause" over the control socket: time stops, windows keep drawing
+    Telemetry* tm = opt->telemetryName || opt->metricsPath? telemetry_open(opt->telemetryName) : NULL;
+    MetricsExporter* mx = tm && opt->metricsPath? metrics_start(tm, opt->metricsPath, opt->metricsInterval) : NULL;
+
+    FrameStats st={0};
+    double start0 = (double)time_now_us()*1e-6;
+    double last = start0;
+    double simTime = 0.0; // sum of dt; drives colour cycling so replays are deterministic
+    double t0 = opt->analytic? opt->startTime : 0.0; // the analytic model can start anywhere in time
+    double h = 1.0/(double)opt->simHz, acc = 0.0; // fixed step and unsimulated remainder
     while(1){
-        // check should close
+        // check should close (offscreen targets never close; --frames bounds headless runs)
         int anyOpen=0;
-        for(int w=0; w<scr->count; w++) if(!glfwWindowShouldClose(scr->arr[w].win)) anyOpen=1; else anyOpen|=0;
+        for(int w=0; w<scr->count; w++) if(!scr->arr[w].win || !glfwWindowShouldClose(scr->arr[w].win)) anyOpen=1; else anyOpen|=0;
         if(!anyOpen) break;
-
-        double now = glfwGetTime(); float dt = (float)(now - last); if(dt>0.1f) dt=0.1f; last=now;
+        if(opt->maxFrames>0 && st.frames>=opt->maxFrames) break;
+
+        uint64_t tf=trace_begin();
+        if(ctl && control_frame(ctl, opt, shapes, scr, &meshes, &st, start0, &paused)){ arena_free(&scratch); draw_lists_build(&dl, &scratch, shapes->count); }
+        double now = (double)time_now_us()*1e-6; float dt = (float)(now - last); if(dt>0.1f) dt=0.1f; last=now;
+        if(paused) dt=0.0f;
+        else if(rep){
+            if(!session_next_dt(rep, &dt)) break;
+            if(opt->replayRealtime){ double due=start0+simTime+dt; while((double)time_now_us()*1e-6 < due){ /* spin-wait */ } }
+        }
+        if(rec) session_record_dt(rec, dt);
+        simTime += dt;
+        st.frames++;
+
+        // config edits land before this frame's update, so they show on the next present
+        if(opt->watch && ini_watch_changed(&watch, now)){
+            uint64_t tr=trace_begin();
+            if(shapes_reload(shapes, opt->iniPath, scr, opt->seed, &meshes)){ arena_free(&scratch); draw_lists_build(&dl, &scratch, shapes->count); }
+            trace_end("hot_reload", tr);
+        }
+        ShapeRuntime* runtime=shapes->runtime; ShapeAnim* anim=&shapes->anim; int runtimeCount=shapes->count;
+        uint64_t updateUs0=st.updateUs; long long edges0=st.edges;
 
         // update
-        for(int i=0;i<runtimeCount;i++) update_shape(&runtime[i], dt);
+        uint64_t tz=time_now_us();
+        int steps = 0;
+        if(!opt->analytic){ acc += dt; steps = (int)(acc/h); acc -= steps*h; }
+        UpdateJob uj={ anim, (float)h, steps };
+        if(steps>0) job_parallel_for("update_shapes", runtimeCount, dl.updGrain, update_shapes_job, &uj);
+        st.simSteps += steps;
+        TransformJob xj={ runtime, anim, dl.model, (float)(acc/h), opt->analytic, t0+simTime };
+        job_parallel_for("transforms", runtimeCount, dl.xfGrain, transform_job, &xj);
+        st.updateUs += time_now_us()-tz;
+        trace_end("update_shape", tz);
 
         // draw each window
         for(int w=0; w<scr->count; w++){
-            GLFWwindow* win = scr->arr[w].win; glfwMakeContextCurrent(win);
-            int W,H; glfwGetFramebufferSize(win,&W,&H); glViewport(0,0,W,H);
+            tz=time_now_us();
+            GLFWwindow* win = scr->arr[w].win; int W=scr->arr[w].width, H=scr->arr[w].height;
+            if(win){ glfwMakeContextCurrent(win); glfwGetFramebufferSize(win,&W,&H); }
+            else headless_bind_target(&scr->arr[w]);
+            if(tm) telemetry_window_begin(&scr->arr[w]);
+            int od = opt->debugOverdraw && overdraw_begin(&scr->arr[w], W, H, &opt->debugOverdraw);
+            glViewport(0,0,W,H);
             glClearColor(0,0,0,0); glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
             Camera cam = make_camera(W,H); apply_proj_view(&cam);
 
-            // draw assigned shapes
-            for(int i=0;i<count[w];i++){
-                int idx = mapIdx[start[w]+i];
-                draw_shape(&runtime[idx], &cam, brightness, thickness, now);
+            // draw this window's shapes: one contiguous run of the runtime array
+            for(int idx=scr->arr[w].startIndex, e=idx+scr->arr[w].count; idx<e; idx++){
+                st.edges += draw_shape(&runtime[idx], anim, idx, &dl.model[idx], &cam, opt->brightness, opt->thickness, t0+simTime);
             }
-
-            glfwSwapBuffers(win);
+            if(od) overdraw_end(&scr->arr[w], w, !opt->headless && st.frames%OD_REPORT_FRAMES==0);
+            if(tm) telemetry_window_drawn(&scr->arr[w]);
+            uint64_t drawUs=time_now_us()-tz;
+            st.drawUs += drawUs;
+            trace_end_arg("draw", tz, "window", w);
+
+            tz=time_now_us();
+            if(win) glfwSwapBuffers(win); else glFinish(); // offscreen: wait for the screen to be fully rendered
+            st.presentUs += time_now_us()-tz;
+            if(tm) telemetry_window_done(&scr->arr[w], drawUs+time_now_us()-tz);
+            trace_end_arg("glfwSwapBuffers", tz, "window", w);
         }
-        glfwPollEvents();
+        if(tm) telemetry_publish(tm, &st, scr, shapes->count, opt, paused, start0, t0+simTime, st.updateUs-updateUs0, st.edges-edges0);
+        if(!opt->headless){
+            glfwPollEvents();
+            if(atomic_exchange(&g_monitorsChanged, 0)){
+                uint64_t th=trace_begin();
+                if(screens_sync(scr, shapes, opt, &meshes)){ arena_free(&scratch); draw_lists_build(&dl, &scratch, shapes->count); }
+                trace_end("monitor_hotplug", th);
+            }
+        }
+        trace_end("frame", tf);
 
-        if(fpsCap>0){ double target=1.0/(double)fpsCap; double end=glfwGetTime(); double elapsed=end-now; if(elapsed<target){ double toWait=target-elapsed; if(toWait>0){ double t0=glfwGetTime(); while(glfwGetTime()-t0 < toWait){ /* spin-wait */ } } } }
+        if(opt->fpsCap>0){ double target=1.0/(double)opt->fpsCap; double end=(double)time_now_us()*1e-6; double elapsed=end-now; if(elapsed<target){ double toWait=target-elapsed; if(toWait>0){ double waitStart=(double)time_now_us()*1e-6; while((double)time_now_us()*1e-6-waitStart < toWait){ /* spin-wait */ } } } }
     }
 
-    free(perCount); free(start); free(count); free(placed); free(mapIdx);
+    st.wallSec=(double)time_now_us()*1e-6 - start0;
+    if(opt->headless){
+        double n = st.frames>0? (double)st.frames : 1.0;
+        fprintf(stderr,"[ornament] headless: %d frames x %d screens (%dx%d) in %.3f s: %.3f ms/frame (update %.3f, draw %.3f, present %.3f), %.1f fps\n",
+                st.frames, scr->count, scr->arr[0].width, scr->arr[0].height, st.wallSec, st.wallSec*1000.0/n, st.updateUs/n/1000.0, st.drawUs/n/1000.0, st.presentUs/n/1000.0, st.wallSec>0? st.frames/st.wallSec : 0.0);
+    }
+    if(opt->statsPath) write_stats_json(opt->statsPath, &st, scr, shapes->count, opt);
+
+    if(opt->watch) ini_watch_close(&watch);
+    control_close(ctl);
+    metrics_stop(mx);
+    telemetry_close(tm);
+    arena_free(&scratch);
+    arena_free(&meshes);
 }